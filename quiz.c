@@ -1,37 +1,203 @@
+// Server mode uses accept4 and other Linux extensions, declared only with _GNU_SOURCE
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
 #include <SDL.h>
 #include <SDL_ttf.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <limits.h>
 #include <time.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <process.h>
+#endif
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
 
 // Screen dimensions
 #define SCREEN_WIDTH 800
 #define SCREEN_HEIGHT 700
 
 // Quiz constants
-#define MAX_QUESTIONS 100
 #define MAX_QUESTION_LENGTH 256
 #define MAX_OPTIONS 4
 #define MAX_OPTION_LENGTH 128
 #define MAX_NAME_LENGTH 50
-#define MAX_PLAYERS 100
 #define QUESTIONS_PER_LEVEL 10
-#define QUESTION_TIME 30 // 30 seconds per question
+#define QUESTION_TIME 30 // Default seconds per question
+#define IDLE_WAIT_MS 1000 // Longest a screen sleeps waiting for input
+
+// Question file format, all integers little-endian
+#define QUESTION_FILE "quiz_questions.dat"
+#define QUESTION_FILE_MAGIC "QZQB"
+#define QUESTION_FILE_VERSION 2
+#define QUESTION_FILE_HEADER_SIZE 32 // Magic, version, record count, string bytes, checksum, bucket counts
+#define QUESTION_FILE_V1_HEADER_SIZE 20 // Version 1 had no bucket counts or bucket table
+#define QUESTION_RECORD_SIZE 28 // Question and option offsets, correct option, difficulty
+
+// Question journal: edits appended since quiz_questions.dat was last written
+#define JOURNAL_FILE "quiz_questions.journal"
+#define JOURNAL_MAGIC "QZQJ"
+#define JOURNAL_HEADER_SIZE 8 // Magic, checksum of the bank file it applies to
+#define JOURNAL_COMPACT_BYTES (64 * 1024) // Fold the journal into the bank once it grows past this
+#define JOURNAL_ADD 1
+#define JOURNAL_EDIT 2
+#define JOURNAL_DELETE 3
+
+// Score log: scores recorded since quiz_players.dat was last written
+#define PLAYER_FILE "quiz_players.dat"
+#define SCORE_LOG_FILE "quiz_scores.log"
+#define SCORE_LOG_MAGIC "QZSL"
+#define SCORE_LOG_HEADER_SIZE 8 // Magic, checksum of the player file it applies to
+#define SCORE_LOG_COMPACT_BYTES (64 * 1024) // Fold the log into the player file once it grows past this
+
+// Attempt history: every finished quiz, appended and never rewritten
+#define ATTEMPT_FILE "quiz_attempts.dat"
+#define ATTEMPT_FILE_MAGIC "QZAH"
+#define ATTEMPT_FILE_VERSION 1
+#define ATTEMPT_FILE_HEADER_SIZE 8 // Magic, version
+#define INITIAL_ATTEMPT_CAPACITY 256
+#define ATTEMPT_STATS_OVERALL 3 // Stats over every difficulty, after one per difficulty
+
+// Leaderboards: one per difficulty ranked by best score, then overall by the sum of those
+#define LEADERBOARD_OVERALL 3
+#define LEADERBOARD_COUNT 4
+#define MIN_QUIZ_SCORE (-QUESTIONS_PER_LEVEL) // Every answer wrong
+#define MAX_QUIZ_SCORE (5 * QUESTIONS_PER_LEVEL) // Every answer right
+
+// Background I/O: jobs the main thread queues for the I/O worker
+#define IO_QUEUE_SIZE 256 // Ring capacity, always a power of two
+#define IO_JOB_SAVE 1 // Atomically replace a file, then reset or reopen its log
+#define IO_JOB_RESET_LOG 2
+#define IO_JOB_OPEN_LOG 3
+#define IO_JOB_APPEND 4
+#define IO_JOB_QUIT 5
+#define IO_LOG_JOURNAL 0
+#define IO_LOG_SCORES 1
+#define IO_LOG_ATTEMPTS 2
+#define IO_LOG_COUNT 3
+#define IO_LOG_HEADER_SIZE 8 // Every log starts with magic and one 32-bit field
+
+// Thread pool: jobs run on worker threads, completions come back to the SDL thread as a POOL_EVENT
+#define POOL_EVENT (SDL_USEREVENT + 1) // user.data1 is the finished PoolJob
+#define POOL_MAX_WORKERS 32
+#define POOL_INITIAL_DEQUE_CAPACITY 64 // Jobs per worker deque, always a power of two
+
+// Startup stages, each loaded as a pool job and reported with a STARTUP_EVENT
+#define STARTUP_EVENT SDL_USEREVENT // user.code is the stage that finished
+#define STARTUP_FONT 0
+#define STARTUP_BANK 1
+#define STARTUP_PLAYERS 2
+#define STARTUP_STAGES 3
+
+// Timer wheel: question deadlines for any number of sessions
+#define TIMER_WHEEL_TICK_MS 10 // Resolution, a timer fires at most this long after its deadline
+#define TIMER_WHEEL_BITS 6
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS) // Slots per level
+#define TIMER_WHEEL_LEVELS 3 // Covers 64^3 ticks, about 43 minutes; later deadlines wait at the top
+#define TIMER_WHEEL_DUE (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS) // List of fired timers not yet collected
+
+// Server mode: line-based protocol over a local socket
+#define SERVER_LINE_LENGTH 256 // Longest request line a client may send
+#define SERVER_OUTPUT_LIMIT (64 * 1024) // Clients that fall this far behind on reading are dropped
+#define SERVER_MAX_EVENTS 64
+
+// Bulk import: questions streamed from a CSV or JSON lines file
+#define IMPORT_BUFFER_SIZE (1024 * 1024) // Bytes read at a time, also the longest record accepted
+#define IMPORT_PATH_LENGTH 256
+#define IMPORT_MAX_FIELDS 8 // CSV columns kept per record, enough to see a record has too many
+#define IMPORT_REPORTED_ERRORS 10 // Rejected records printed before the rest are only counted
+#define IMPORT_PROGRESS_MS 100 // Redraw interval of the progress screen
+#define IMPORT_ASSIGN_DIFFICULTY -1 // Left to the import: the level with fewest questions
+#define IMPORT_BAD_DIFFICULTY -2
+
+// FNV-1a, the hash behind file checksums, the string pool and the text cache
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME 16777619u
+
+// Question storage constants
+#define INITIAL_QUESTION_CAPACITY 64
+#define INITIAL_PLAYER_CAPACITY 64
+#define PLAYER_TABLE_INITIAL_SLOTS 128 // Name table size, always a power of two
+#define STRING_POOL_INITIAL_CAPACITY 4096 // Bytes of string data
+#define STRING_POOL_INITIAL_SLOTS 256 // Hash table size, always a power of two
+
+// Modal wait results
+#define MODAL_TIMEOUT -1
+#define MODAL_QUIT -2
+
+// Widget constants
+#define MAX_WIDGETS 16
+#define WIDGET_LABEL 0
+#define WIDGET_BUTTON 1
+
+// Toast constants
+#define MAX_TOASTS 4
+#define TOAST_HEIGHT 40
+
+// Glyph atlas constants
+#define ATLAS_FIRST_GLYPH 32
+#define ATLAS_GLYPH_COUNT 224 // Latin-1 range 32..255, same as TTF_RenderText
+#define ATLAS_WIDTH 512
+#define ATLAS_BATCH_GLYPHS 64 // Glyph quads submitted per SDL_RenderGeometry call
+
+// Text cache constants
+#define TEXT_CACHE_MAX_ENTRIES 256
+#define TEXT_CACHE_BUCKETS 512
+#define TEXT_CACHE_DEFAULT_BUDGET (8 * 1024 * 1024) // Bytes of cached texture pixels
 
 // Difficulty levels
 #define DIFFICULTY_EASY 0
 #define DIFFICULTY_MEDIUM 1
 #define DIFFICULTY_HARD 2
 
-// Question structure
+// String pool: interned text packed back to back, referenced by offset.
+// Each distinct string is stored once, so equal offsets mean equal text.
+typedef struct {
+    const char* base;      // Optional read-only strings (a mapped bank) at offsets below base_size
+    Uint32 base_size;
+    char* data;            // Strings added at runtime, at offsets from base_size up
+    Uint32 used;
+    Uint32 capacity;
+    Uint32* slots;         // Open-addressed hash table of offsets, 0 marks an empty slot
+    Uint32 slot_count;
+    Uint32 string_count;
+} StringPool;
+
+// Question structure, text lives in the game's string pool
+typedef struct {
+    Uint32 question;              // Pool offset of the question text
+    Uint32 options[MAX_OPTIONS];  // Pool offsets of the option texts
+    int correct_option;
+    int difficulty;
+} Question;
+
+// Mapped banks use file records as Question structs in place
+SDL_COMPILE_TIME_ASSERT(question_record_size, sizeof(Question) == QUESTION_RECORD_SIZE);
+
+// Fixed-size question record used by quiz_questions.dat before the versioned format
 typedef struct {
     char question[MAX_QUESTION_LENGTH];
     char options[MAX_OPTIONS][MAX_OPTION_LENGTH];
     int correct_option;
     int difficulty;
-} Question;
+} QuestionRecord;
 
 // Player structure
 typedef struct {
@@ -39,49 +205,612 @@ typedef struct {
     int scores[3];  // Scores for each difficulty level
 } Player;
 
+// One finished quiz, as passed in and out of the attempt history
+typedef struct {
+    Sint64 timestamp;     // When the quiz finished, seconds since the epoch
+    int player;           // Player ID
+    int difficulty;
+    int score;
+    Uint16 correct_mask;  // Bit q set when question q of the quiz was answered correctly
+    int question_count;
+    Uint32 answer_ms;     // Time spent answering all questions, a timeout counts in full
+} Attempt;
+
+// Attempt history stored a column per field, so aggregates over a player's
+// attempts are tight loops over the few columns they read
+typedef struct {
+    Sint64* timestamp;
+    int* player;
+    Uint8* difficulty;
+    Sint16* score;
+    Uint16* correct_mask;
+    Uint8* question_count;
+    Uint32* answer_ms;
+    int count;
+    int capacity;
+} AttemptHistory;
+
+// Correctness of a whole quiz fits in one mask
+SDL_COMPILE_TIME_ASSERT(attempt_mask_size, QUESTIONS_PER_LEVEL <= 16);
+
+// Aggregates over a player's attempts
+typedef struct {
+    int attempts;
+    int best;
+    float mean;
+    float trend;           // Score gained per attempt, from a least-squares fit
+    float accuracy;        // Fraction of questions answered correctly
+    float mean_answer_ms;  // Average time taken per question
+} AttemptStats;
+
+// Leaderboard: players bucketed by a score in a fixed range, highest bucket first.
+// A Fenwick tree over the bucket sizes counts the players above any score, so
+// updates and rank queries are O(log range) and listing a page starts at its bucket.
+typedef struct {
+    int min_score;
+    int max_score;
+    int range;             // Buckets, one per score from max_score down to min_score
+    int* head;             // First player in each bucket, -1 when empty
+    int* tail;
+    int* fenwick;          // Bucket sizes, 1-based
+    int* score;            // Per player: score they are ranked by, below min_score when unranked
+    int* next;             // Per player: next and previous player in the same bucket
+    int* prev;
+    int player_capacity;
+    int total;             // Players ranked
+} Leaderboard;
+
 // Game state structure
 typedef struct {
-    Question questions[MAX_QUESTIONS];
+    Question* questions;
     int total_questions;
+    int question_capacity;
+    StringPool strings;
     char current_player[MAX_NAME_LENGTH];
     int current_score[3];  // Scores for each difficulty level
-    int time_remaining;
-    Uint32 question_start_time;
-    Player players[MAX_PLAYERS];
+    Player* players;             // Indexed by player ID; players are never removed, so IDs are stable
     int total_players;
+    int player_capacity;
+    int* player_slots;           // Open-addressed name table of player ID + 1, 0 marks an empty slot
+    int player_slot_count;
+    
+    // Question bank index, kept in step with questions on add and delete
+    int* difficulty_index[3];  // Question indices bucketed by difficulty
+    int difficulty_count[3];
+    int* bucket_slot;          // Position of each question in its bucket
+    
+    // Bank mapped read-only with --mmap-bank. Questions below mapped_count are read
+    // from the mapping until an edit copies them into questions (the overlay).
+    const unsigned char* mapped_file;
+    size_t mapped_size;
+    const Question* mapped_questions;
+    const int* mapped_index[3];  // Difficulty buckets stored in the file
+    int mapped_count;
+    bool* overlaid;              // Set once the bank is writable: which mapped questions were copied
+    
+    // Journal of edits not yet folded into the bank file
+    Uint32 bank_checksum;        // Checksum from the bank file's header, 0 for old-format files
+    long journal_size;           // Bytes queued to the journal since it was last reset
+    
+    // Log of scores not yet folded into the player file
+    Uint32 players_checksum;     // Checksum of the player file as loaded or last saved
+    long score_log_size;
+    
+    // Every quiz each player has finished
+    AttemptHistory attempts;
+    
+    // Rankings, kept up to date as scores come in
+    Leaderboard leaderboards[LEADERBOARD_COUNT];  // Per difficulty, then LEADERBOARD_OVERALL
 } GameState;
 
+// Quiz session states
+#define QUIZ_STATE_QUESTION 0 // Waiting for an answer to the current question
+#define QUIZ_STATE_FINISHED 1 // Every question answered or timed out
+#define QUIZ_STATE_RECORDED 2 // Score added to the player's history
+
+// What happened to the current question on a submit or tick
+#define QUIZ_RESULT_NONE 0 // Still waiting, or the call did not apply
+#define QUIZ_RESULT_CORRECT 1
+#define QUIZ_RESULT_WRONG 2
+#define QUIZ_RESULT_TIMEOUT 3
+
+// One timer of a wheel, identified by its index
+typedef struct {
+    Uint64 deadline;  // Tick it fires on
+    int list;         // Slot list it is on, -1 when not armed
+    int prev;         // Neighbours on that list, -1 at the ends
+    int next;
+} Timer;
+
+// Hierarchical timer wheel. Level 0 has a slot per tick and each level above is
+// TIMER_WHEEL_SLOTS times coarser; a timer moves down a level when its slot comes
+// round, so arming, disarming and firing are all constant time.
+typedef struct {
+    Timer* timers;
+    int capacity;
+    int scheduled;                  // Timers in slots, not counting the due list
+    Uint64 now;                     // Last tick processed
+    int heads[TIMER_WHEEL_DUE + 1]; // Slot lists, then the due list
+} TimerWheel;
+
+// One player's run through a quiz. The quiz_engine_* functions hold all the
+// rules and never touch SDL rendering, events or the clock: time only moves
+// when the caller ticks it.
+typedef struct {
+    int state;
+    int difficulty;
+    int order[QUESTIONS_PER_LEVEL];  // Bank indices of the questions drawn
+    int question_count;
+    int current;                     // Position in order of the question being asked
+    Uint32 elapsed_ms;               // Time spent on the current question
+    Uint32 time_limit_ms;            // Time allowed for each question
+    int score;
+    Uint16 correct_mask;             // Bit q set when question q was answered correctly
+    Uint32 answer_ms;                // Time spent on all questions so far
+} QuizSession;
+
+#ifdef __linux__
+// One connected client of the quiz server, stored at the index of its socket
+typedef struct {
+    int fd;                   // -1 for an unused slot
+    char name[MAX_NAME_LENGTH];
+    QuizSession session;
+    bool in_quiz;
+    Uint64 last_tick_ms;      // When the session's clock was last advanced
+    char input[SERVER_LINE_LENGTH];
+    int input_used;
+    char* output;             // Bytes not yet accepted by the socket
+    size_t output_used;
+    size_t output_capacity;
+    bool want_write;          // Registered for EPOLLOUT while output is pending
+} ServerClient;
+
+// Every session shares the server's GameState; the bank is only read
+typedef struct {
+    GameState* game;
+    int epoll_fd;
+    int listen_fd;
+    ServerClient* clients;
+    int client_capacity;
+    int client_count;
+    TimerWheel timers;        // Question deadlines, one timer per client by fd
+} QuizServer;
+#endif
+
+// Modal target: a clickable area of a modal screen and what clicking it does
+typedef struct {
+    int x, y, w, h;
+    int result;                      // Returned by wait_modal when clicked
+    void (*on_click)(void* data);    // Optional callback run before returning
+    void* data;
+} ModalTarget;
+
+// Widget: a label or button a screen declares once and then renders and hit-tests
+typedef struct {
+    SDL_Rect rect;        // Labels only use x and y
+    int type;
+    bool visible;
+    const char* text;     // Owned by the screen, may be updated between frames
+    SDL_Color bg_color;
+    SDL_Color text_color;
+} Widget;
+
+// Flat list of the widgets on one screen, in draw order
+typedef struct {
+    Widget items[MAX_WIDGETS];
+    int count;
+} WidgetList;
+
+// Toast: a timed message drawn over whatever screen is current
+typedef struct {
+    char text[MAX_QUESTION_LENGTH];
+    SDL_Color color;
+    Uint32 expires_at;
+} Toast;
+
+// Active toasts, oldest first
+static Toast toasts[MAX_TOASTS];
+static int toast_count = 0;
+
+// Glyph atlas structure: every glyph of a font rasterized once into one texture
+typedef struct {
+    SDL_Renderer* renderer;
+    TTF_Font* font;
+    SDL_Texture* texture;
+    int width;
+    int height;
+    SDL_Rect glyphs[ATLAS_GLYPH_COUNT];  // Source rectangle of each glyph in the texture
+    int advances[ATLAS_GLYPH_COUNT];     // Horizontal pen advance of each glyph
+    int line_height;
+    int indices[ATLAS_BATCH_GLYPHS * 6]; // Shared index buffer for the glyph quads
+} GlyphAtlas;
+
+// Atlas used for text that changes every frame, built on first use
+static GlyphAtlas glyph_atlas = {0};
+
+// Text cache entry: one rendered line keyed on (font, text, color)
+typedef struct {
+    TTF_Font* font;
+    SDL_Color color;
+    char text[MAX_QUESTION_LENGTH];
+    Uint32 hash;
+    SDL_Texture* texture;
+    int w;
+    int h;
+    size_t bytes;
+    int hash_next; // Next entry in the same bucket (or in the free list)
+    int lru_prev;
+    int lru_next;
+} TextCacheEntry;
+
+// LRU cache of whole-line textures for strings that rarely change
+typedef struct {
+    SDL_Renderer* renderer;
+    TextCacheEntry entries[TEXT_CACHE_MAX_ENTRIES];
+    int buckets[TEXT_CACHE_BUCKETS];
+    int lru_head; // Most recently used
+    int lru_tail; // Least recently used
+    int free_head;
+    int count;
+    size_t bytes_used;
+    size_t byte_budget;
+    Uint64 hits;
+    Uint64 misses;
+    Uint64 evictions;
+} TextCache;
+
+// Cache used by render_text and render_button
+static TextCache text_cache = {0};
+
+// One unit of work for the I/O worker, which owns data once it is queued
+typedef struct {
+    int type;
+    int log;                       // IO_LOG_* the job writes or, for a save, resets afterwards
+    const char* path;              // File a save replaces
+    unsigned char* data;           // Save contents or append payload
+    size_t size;
+    unsigned char header[IO_LOG_HEADER_SIZE];  // Log header written by a reset
+    bool has_header;               // A save without one reopens its log instead of resetting it
+    int generation;                // Saves of the same file are numbered so stale ones are skipped
+} IoJob;
+
+// Single-producer, single-consumer ring: the main thread only advances tail and
+// the worker only advances head, so neither side ever takes a lock
+typedef struct {
+    IoJob jobs[IO_QUEUE_SIZE];
+    SDL_atomic_t head;
+    SDL_atomic_t tail;
+    SDL_sem* ready;                // Posted once per queued job
+    SDL_Thread* thread;            // NULL until started, jobs then run on the caller
+    FILE* logs[IO_LOG_COUNT];      // Open logs, only touched by whoever runs jobs
+    bool log_dirty[IO_LOG_COUNT];  // Written since the last sync
+    SDL_atomic_t log_failed[IO_LOG_COUNT];
+    SDL_atomic_t save_generation[IO_LOG_COUNT];
+} IoQueue;
+
+static IoQueue io_queue = {0};
+
+// A job for the thread pool: run is called on a worker, then done, if set, on the SDL thread
+typedef struct {
+    void (*run)(void* data);
+    void (*done)(void* data);
+    void* data;
+} PoolJob;
+
+// One worker's jobs. The worker takes its newest job, idle workers steal the oldest half
+typedef struct {
+    SDL_mutex* lock;
+    PoolJob** jobs;          // Ring buffer
+    int capacity;            // Always a power of two
+    int head;                // Oldest job
+    int count;
+} PoolDeque;
+
+typedef struct {
+    SDL_Thread* threads[POOL_MAX_WORKERS];
+    PoolDeque deques[POOL_MAX_WORKERS];
+    int worker_count;        // Deques, one per worker; 0 when jobs run inline on the submitting thread
+    SDL_sem* work;           // Posted once per queued job
+    SDL_atomic_t next_deque; // Round robin for jobs queued from outside the pool
+    SDL_atomic_t quitting;
+    SDL_TLSID worker_id;     // Worker index + 1 on pool threads, 0 elsewhere
+} ThreadPool;
+
+// Thread pool, shared by every subsystem with work to take off the SDL thread
+static ThreadPool thread_pool = {0};
+
+// Startup loading shared between main and the stage jobs. The bank and player
+// stages write disjoint parts of game; main reads a stage's results only after its event.
+typedef struct {
+    GameState* game;
+    bool map_bank;
+    TTF_Font* font;                         // Result of the font stage, NULL if no font loaded
+    bool done[STARTUP_STAGES];              // Main thread only
+} Startup;
+
+// One bulk import. A pool job parses the file into the batch's own pool and questions,
+// then the SDL thread merges them into the bank; game is only touched there.
+typedef struct {
+    GameState* game;
+    char path[IMPORT_PATH_LENGTH];
+    bool json;                 // JSON lines rather than CSV
+    bool header_checked;       // A CSV header row can only be the first record
+    StringPool strings;        // Text of the parsed questions
+    Question* questions;       // Offsets into strings, difficulty may be IMPORT_ASSIGN_DIFFICULTY
+    int count;
+    int capacity;
+    int records;               // Records read, blank lines and a header aside
+    int rejected;
+    char error[128];           // Why the import failed, or else the first rejected record
+    bool failed;               // The file could not be read through, nothing is merged
+    SDL_atomic_t progress;     // Percent of the file read so far
+    int added;                 // Set by the merge
+    int duplicates;
+    bool finished;             // SDL thread only: merged and reported
+    bool abandoned;            // SDL thread only: the screen left first, the merge frees the batch
+} ImportBatch;
+
+// Logs the I/O worker appends to, indexed by IO_LOG_*
+static const char* io_log_paths[IO_LOG_COUNT] = {JOURNAL_FILE, SCORE_LOG_FILE, ATTEMPT_FILE};
+
+// Seconds allowed per question at each difficulty
+static const int question_time_limits[3] = {QUESTION_TIME, QUESTION_TIME, QUESTION_TIME};
+
+#ifdef __linux__
+static volatile sig_atomic_t server_stopping = 0;
+#endif
+
 // Function prototypes
-bool init_sdl(SDL_Window** window, SDL_Renderer** renderer, TTF_Font** font);
+bool init_sdl(SDL_Window** window, SDL_Renderer** renderer);
+TTF_Font* open_font(void);
 void close_sdl(SDL_Window* window, SDL_Renderer* renderer, TTF_Font* font);
 void render_text(SDL_Renderer* renderer, TTF_Font* font, const char* text, int x, int y, SDL_Color color);
 void render_button(SDL_Renderer* renderer, TTF_Font* font, const char* text, int x, int y, int w, int h, SDL_Color bg_color, SDL_Color text_color);
+void render_centered_text(SDL_Renderer* renderer, TTF_Font* font, const char* text, SDL_Rect rect, SDL_Color color);
 bool is_button_clicked(int mouse_x, int mouse_y, int btn_x, int btn_y, int btn_w, int btn_h);
+bool event_invalidates_screen(const SDL_Event* event);
+int wait_modal(const ModalTarget* targets, int target_count, Uint32 timeout_ms);
+
+// Widget functions
+int add_label(WidgetList* list, const char* text, int x, int y, SDL_Color color);
+int add_button(WidgetList* list, const char* text, int x, int y, int w, int h, SDL_Color bg_color, SDL_Color text_color);
+void render_widgets(SDL_Renderer* renderer, TTF_Font* font, const WidgetList* list);
+int hit_test_widgets(const WidgetList* list, int mouse_x, int mouse_y);
+
+// Toast functions
+void show_toast(const char* text, SDL_Color color, Uint32 duration_ms);
+bool prune_toasts(void);
+void render_toasts(SDL_Renderer* renderer, TTF_Font* font);
+int toast_wait_timeout(int timeout_ms);
 void get_text_input(SDL_Renderer* renderer, TTF_Font* font, char* buffer, int max_length, const char* prompt);
 void render_timer(SDL_Renderer* renderer, TTF_Font* font, int time_remaining, int x, int y);
 
+// Glyph atlas functions
+bool glyph_atlas_build(GlyphAtlas* atlas, SDL_Renderer* renderer, TTF_Font* font);
+void glyph_atlas_destroy(GlyphAtlas* atlas);
+GlyphAtlas* get_glyph_atlas(SDL_Renderer* renderer, TTF_Font* font);
+int glyph_atlas_text_width(const GlyphAtlas* atlas, const char* text);
+void glyph_atlas_draw(GlyphAtlas* atlas, const char* text, int x, int y, SDL_Color color);
+void render_dynamic_text(SDL_Renderer* renderer, TTF_Font* font, const char* text, int x, int y, SDL_Color color);
+
+// Text cache functions
+void text_cache_init(TextCache* cache, SDL_Renderer* renderer, size_t byte_budget);
+void text_cache_clear(TextCache* cache);
+void text_cache_set_budget(TextCache* cache, size_t byte_budget);
+Uint32 text_cache_hash(TTF_Font* font, const char* text, SDL_Color color);
+void text_cache_lru_unlink(TextCache* cache, int index);
+void text_cache_lru_push_front(TextCache* cache, int index);
+void text_cache_evict_lru(TextCache* cache);
+TextCacheEntry* text_cache_get(TextCache* cache, TTF_Font* font, const char* text, SDL_Color color);
+TextCache* get_text_cache(SDL_Renderer* renderer);
+
 // Master mode functions
 void master_login(SDL_Renderer* renderer, TTF_Font* font, GameState* game);
 void add_questions(SDL_Renderer* renderer, TTF_Font* font, GameState* game);
+void import_questions(SDL_Renderer* renderer, TTF_Font* font, GameState* game);
 void view_questions(SDL_Renderer* renderer, TTF_Font* font, GameState* game);
 void edit_question(SDL_Renderer* renderer, TTF_Font* font, GameState* game, int index);
 void delete_question(SDL_Renderer* renderer, TTF_Font* font, GameState* game, int index);
-void save_questions(GameState* game);
+int select_correct_option(SDL_Renderer* renderer, TTF_Font* font, const char* const options[MAX_OPTIONS]);
+bool save_questions(GameState* game);
 void load_questions(GameState* game);
-void save_players(GameState* game);
+bool load_question_file(GameState* game, const char* path);
+bool map_questions(GameState* game);
+bool load_question_container(GameState* game, const unsigned char* data, size_t size);
+bool load_legacy_questions(GameState* game, const unsigned char* data, size_t size);
+
+// Question journal functions
+void journal_open(GameState* game);
+bool journal_replay(GameState* game, const unsigned char* data, size_t size);
+void journal_reset(GameState* game);
+void journal_append(GameState* game, int op, int index, const Question* question);
+void journal_compact(GameState* game);
+void journal_close(GameState* game);
+bool save_players(GameState* game);
+
+// Player registry functions
+bool player_registry_reserve(GameState* game, int capacity);
+bool player_registry_rehash(GameState* game, int slot_count);
+int find_player(const GameState* game, const char* name);
+int register_player(GameState* game, const char* name);
+void player_registry_free(GameState* game);
+
 void load_players(GameState* game);
+bool load_player_file(GameState* game, const char* path);
+
+// Score log functions
+void score_log_open(GameState* game);
+bool score_log_replay(GameState* game, const unsigned char* data, size_t size);
+void score_log_reset(GameState* game);
+void score_log_append(GameState* game, int id, int difficulty, int score);
+void score_log_compact(GameState* game);
+void score_log_close(GameState* game);
+
+// Attempt history functions
+void attempt_history_open(GameState* game);
+size_t attempt_history_replay(GameState* game, const unsigned char* data, size_t size);
+bool attempt_history_reserve(AttemptHistory* history, int capacity);
+void attempt_history_add(AttemptHistory* history, const Attempt* attempt);
+void attempt_history_append(GameState* game, const Attempt* attempt);
+void attempt_stats_all(const AttemptHistory* history, int player, AttemptStats stats[ATTEMPT_STATS_OVERALL + 1]);
+void attempt_history_close(GameState* game);
+
+// Leaderboard functions
+bool leaderboard_init(Leaderboard* board, int min_score, int max_score);
+bool leaderboard_reserve(Leaderboard* board, int player_capacity);
+void leaderboard_fenwick_add(Leaderboard* board, int bucket, int delta);
+void leaderboard_set(Leaderboard* board, int player, int score);
+int leaderboard_rank(const Leaderboard* board, int player);
+int leaderboard_list(const Leaderboard* board, int start, int* out, int max_count);
+void leaderboard_destroy(Leaderboard* board);
+void leaderboard_build(GameState* game);
+void leaderboard_submit(GameState* game, int player, int difficulty, int score);
+void leaderboard_free(GameState* game);
+
+// Timer wheel functions
+void timer_wheel_init(TimerWheel* wheel, Uint64 now_ms);
+bool timer_wheel_reserve(TimerWheel* wheel, int id);
+void timer_wheel_arm(TimerWheel* wheel, int id, Uint64 deadline_ms);
+void timer_wheel_disarm(TimerWheel* wheel, int id);
+void timer_wheel_place(TimerWheel* wheel, int id);
+void timer_wheel_link(TimerWheel* wheel, int id, int list);
+void timer_wheel_unlink(TimerWheel* wheel, int id);
+void timer_wheel_cascade(TimerWheel* wheel, int list);
+int timer_wheel_expire(TimerWheel* wheel, Uint64 now_ms);
+int timer_wheel_timeout(const TimerWheel* wheel, Uint64 now_ms);
+void timer_wheel_free(TimerWheel* wheel);
+
+// Quiz engine functions
+void quiz_engine_start(QuizSession* session, const GameState* game, int difficulty);
+const Question* quiz_engine_question(const QuizSession* session, const GameState* game);
+int quiz_engine_time_remaining(const QuizSession* session, Uint32 unticked_ms);
+int quiz_engine_submit(QuizSession* session, const GameState* game, int option, Uint32 elapsed_ms);
+int quiz_engine_tick(QuizSession* session, Uint32 elapsed_ms);
+void quiz_engine_advance(QuizSession* session);
+int quiz_engine_finish(QuizSession* session, GameState* game, const char* player, Sint64 timestamp);
 
 // Student mode functions
 void student_login(SDL_Renderer* renderer, TTF_Font* font, GameState* game);
 void start_quiz(SDL_Renderer* renderer, TTF_Font* font, GameState* game, int difficulty);
 void show_results(SDL_Renderer* renderer, TTF_Font* font, GameState* game, int difficulty);
 void show_player_history(SDL_Renderer* renderer, TTF_Font* font, GameState* game);
-void add_player_score(GameState* game, const char* name, int difficulty, int score);
+int add_player_score(GameState* game, const char* name, int difficulty, int score);
+
+// String pool functions
+Uint32 string_pool_hash(const char* text);
+bool string_pool_rehash(StringPool* pool, Uint32 slot_count);
+bool string_pool_adopt(StringPool* pool, char* data, Uint32 size);
+Uint32 string_pool_intern(StringPool* pool, const char* text);
+Uint32 string_pool_find(const StringPool* pool, const char* text);
+const char* string_pool_get(const StringPool* pool, Uint32 offset);
+void string_pool_free(StringPool* pool);
+
+// Question bank functions
+bool question_bank_reserve(GameState* game, int capacity);
+bool question_bank_make_writable(GameState* game);
+void question_bank_free(GameState* game);
+const Question* get_question(const GameState* game, int index);
+Question* question_bank_edit(GameState* game, int index);
+const int* question_bank_bucket(const GameState* game, int difficulty);
+const char* question_text(const GameState* game, const Question* question);
+const char* option_text(const GameState* game, const Question* question, int option);
+int question_bank_add(GameState* game, const Question* question);
+bool question_bank_remove(GameState* game, int index);
+int count_questions_by_difficulty(GameState* game, int difficulty);
+int question_bank_sample(const GameState* game, int difficulty, int* out, int max_count);
+
+// Background I/O functions
+bool io_start(void);
+void io_submit(IoJob* job);
+void io_save_file(const char* path, unsigned char* data, size_t size, int log, const unsigned char* header);
+void io_reset_log(int log, const unsigned char* header);
+void io_open_log(int log);
+void io_append(int log, const unsigned char* payload, size_t payload_size);
+bool io_log_failed(int log);
+void io_shutdown(void);
+int io_worker(void* unused);
+void io_run_job(IoJob* job);
+bool io_reopen_log(int log, const unsigned char* header);
+void io_sync_log(int log);
+void io_sync_logs(void);
+
+// Thread pool functions
+bool pool_start(void);
+void pool_submit(void (*run)(void* data), void (*done)(void* data), void* data);
+void pool_complete(const SDL_Event* event);
+void pool_shutdown(void);
+int pool_worker(void* data);
+void pool_run(PoolJob* job);
+PoolJob* pool_take(int worker);
+PoolJob* pool_steal(int thief);
+bool pool_deque_push(PoolDeque* deque, PoolJob* job);
+
+// Loading functions
+void load_question_bank(GameState* game, bool map_bank);
+void load_player_history(GameState* game);
+
+// Startup functions
+void startup_begin(Startup* startup);
+void startup_load_font(void* data);
+void startup_load_bank(void* data);
+void startup_load_players(void* data);
+void startup_finish(int stage);
+bool startup_handle_event(Startup* startup, const SDL_Event* event);
+bool startup_ready(const Startup* startup);
+void render_startup_progress(SDL_Renderer* renderer, const Startup* startup);
+
+// Import functions
+ImportBatch* import_batch_new(GameState* game, const char* path);
+void import_batch_free(ImportBatch* batch);
+void import_run(void* data);
+int import_csv_record(char* data, size_t size, bool at_end, size_t* used, char** fields, int* field_count);
+void import_csv_fields(ImportBatch* batch, char** fields, int field_count);
+void import_json_line(ImportBatch* batch, char* line);
+char* json_skip_space(char* p);
+char* json_string(char* p, char** text);
+Uint32 json_hex4(const char* p);
+char* json_skip_value(char* p);
+int import_parse_correct(const char* text);
+int import_parse_difficulty(const char* text);
+void import_reject(ImportBatch* batch, const char* reason);
+void import_add(ImportBatch* batch, char* question, char** options, int correct, int difficulty);
+void import_merge(ImportBatch* batch);
+void import_done(void* data);
+void import_summary(const ImportBatch* batch, char* text, size_t size);
+int run_import(const char* path, bool map_bank);
+
+// Server mode functions
+int run_server(const char* socket_path, int port, bool map_bank);
+#ifdef __linux__
+int server_listen(const char* socket_path, int port);
+Uint64 server_now_ms(void);
+void server_stop(int signal_number);
+bool server_reserve_clients(QuizServer* server, int fd);
+void server_accept(QuizServer* server, Uint64 now);
+void server_read(QuizServer* server, ServerClient* client, Uint64 now);
+void server_handle_line(QuizServer* server, ServerClient* client, char* line, Uint64 now);
+void server_send_question(QuizServer* server, ServerClient* client, Uint64 now);
+void server_question_done(QuizServer* server, ServerClient* client, int result, int correct_option, Uint64 now);
+void server_send(QuizServer* server, ServerClient* client, const char* format, ...);
+void server_send_field(QuizServer* server, ServerClient* client, const char* text);
+bool server_output_reserve(ServerClient* client, size_t extra);
+void server_flush(QuizServer* server, ServerClient* client);
+void server_close_client(QuizServer* server, ServerClient* client);
+void server_expire_timers(QuizServer* server, Uint64 now);
+#endif
 
 // Utility functions
 void add_default_questions(GameState* game);
-void shuffle_questions(Question* questions, int count);
-int count_questions_by_difficulty(GameState* game, int difficulty);
+void put_le32(unsigned char* p, Uint32 value);
+Uint32 get_le32(const unsigned char* p);
+Uint32 fnv1a(Uint32 hash, const void* data, size_t size);
+Uint32 checksum_bytes(const unsigned char* data, size_t size);
+bool log_append_record(FILE* file, const unsigned char* payload, size_t payload_size);
+const unsigned char* log_next_record(const unsigned char* data, size_t size, size_t* pos, size_t* payload_size);
+unsigned char* read_file(const char* path, size_t* size);
+bool sync_file(FILE* file);
+bool copy_file(const char* from, const char* to);
+bool atomic_write_file(const char* path, const void* data, size_t size);
 
 int main(int argc, char* argv[]) {
     SDL_Window* window = NULL;
@@ -89,23 +818,45 @@ int main(int argc, char* argv[]) {
     TTF_Font* font = NULL;
     GameState game = {0};
 
+    // --mmap-bank serves questions straight from a read-only mapping of the bank file.
+    // --server PATH or --server-port PORT hosts quiz sessions instead of opening a window.
+    // --import FILE adds the questions in a CSV or JSON lines file to the bank and exits.
+    bool map_bank = false;
+    const char* server_path = NULL;
+    const char* import_path = NULL;
+    int server_port = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--mmap-bank") == 0) {
+            map_bank = true;
+        } else if (strcmp(argv[i], "--server") == 0 && i + 1 < argc) {
+            server_path = argv[++i];
+        } else if (strcmp(argv[i], "--server-port") == 0 && i + 1 < argc) {
+            server_port = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--import") == 0 && i + 1 < argc) {
+            import_path = argv[++i];
+        }
+    }
+
     // Seed random number generator
     srand(time(NULL));
 
-    // Initialize SDL
-    if (!init_sdl(&window, &renderer, &font)) {
-        return 1;
+    if (server_path || server_port > 0) {
+        return run_server(server_path, server_port, map_bank);
+    }
+    if (import_path) {
+        return run_import(import_path, map_bank);
     }
 
-    // Load or create default questions
-    load_questions(&game);
-    if (game.total_questions == 0) {
-        add_default_questions(&game);
-        save_questions(&game);
+    // Initialize SDL
+    if (!init_sdl(&window, &renderer)) {
+        return 1;
     }
 
-    // Load player history
-    load_players(&game);
+    // Load the font, question bank and players in the background, the menu fills in as they arrive
+    pool_start();
+    Startup startup = {&game, map_bank, NULL, {false}};
+    startup_begin(&startup);
+    int status = 0;
 
     // Colors
     SDL_Color WHITE = {255, 255, 255, 255};
@@ -118,58 +869,98 @@ int main(int argc, char* argv[]) {
     bool quit = false;
     SDL_Event event;
 
-    while (!quit) {
-        SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
-        SDL_RenderClear(renderer);
-
-        // Title
-        render_text(renderer, font, "QUIZ GAME", SCREEN_WIDTH/2 - 100, 100, WHITE);
+    WidgetList menu = {0};
+    add_label(&menu, "QUIZ GAME", SCREEN_WIDTH/2 - 100, 100, WHITE);
+    int master_button = add_button(&menu, "Master Login", SCREEN_WIDTH/2 - 100, 250, 200, 50, LIGHT_BLUE, WHITE);
+    int student_button = add_button(&menu, "Student Login", SCREEN_WIDTH/2 - 100, 350, 200, 50, LIGHT_BLUE, WHITE);
+    int exit_button = add_button(&menu, "Exit", SCREEN_WIDTH/2 - 100, 450, 200, 50, LIGHT_BLUE, WHITE);
 
-        // Master Login Button
-        render_button(renderer, font, "Master Login", SCREEN_WIDTH/2 - 100, 250, 200, 50, LIGHT_BLUE, WHITE);
+    // Logins need the bank and players, so they appear once loading is done
+    menu.items[master_button].visible = false;
+    menu.items[student_button].visible = false;
 
-        // Student Login Button
-        render_button(renderer, font, "Student Login", SCREEN_WIDTH/2 - 100, 350, 200, 50, LIGHT_BLUE, WHITE);
-
-        // Exit Button
-        render_button(renderer, font, "Exit", SCREEN_WIDTH/2 - 100, 450, 200, 50, LIGHT_BLUE, WHITE);
+    bool redraw = true;
+    while (!quit) {
+        redraw |= prune_toasts();
+        if (redraw) {
+            SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
+            SDL_RenderClear(renderer);
+            if (font) {
+                render_widgets(renderer, font, &menu);
+                render_toasts(renderer, font);
+            }
+            if (!startup_ready(&startup)) {
+                render_startup_progress(renderer, &startup);
+            }
+            SDL_RenderPresent(renderer);
+            redraw = false;
+        }
 
-        SDL_RenderPresent(renderer);
+        // Sleep until input arrives instead of redrawing an idle screen
+        if (!SDL_WaitEventTimeout(&event, toast_wait_timeout(IDLE_WAIT_MS))) {
+            continue;
+        }
+        do {
+            if (event_invalidates_screen(&event)) {
+                redraw = true;
+            }
 
-        while (SDL_PollEvent(&event)) {
             if (event.type == SDL_QUIT) {
                 quit = true;
                 break;
             }
 
+            if (startup_handle_event(&startup, &event)) {
+                redraw = true;
+                if (event.user.code == STARTUP_FONT) {
+                    font = startup.font;
+                    if (!font) {
+                        status = 1;
+                        quit = true;
+                        break;
+                    }
+                }
+
+                // Saves made while loading ran on the loading jobs, from here on they go to the I/O worker
+                if (startup_ready(&startup)) {
+                    menu.items[master_button].visible = true;
+                    menu.items[student_button].visible = true;
+                    io_start();
+                }
+            }
+
             if (event.type == SDL_MOUSEBUTTONDOWN) {
                 int mouse_x, mouse_y;
                 SDL_GetMouseState(&mouse_x, &mouse_y);
 
-                // Master Login Button
-                if (is_button_clicked(mouse_x, mouse_y, SCREEN_WIDTH/2 - 100, 250, 200, 50)) {
+                int clicked = hit_test_widgets(&menu, mouse_x, mouse_y);
+                if (clicked == master_button) {
                     master_login(renderer, font, &game);
-                }
-
-                // Student Login Button
-                if (is_button_clicked(mouse_x, mouse_y, SCREEN_WIDTH/2 - 100, 350, 200, 50)) {
+                } else if (clicked == student_button) {
                     student_login(renderer, font, &game);
-                }
-
-                // Exit Button
-                if (is_button_clicked(mouse_x, mouse_y, SCREEN_WIDTH/2 - 100, 450, 200, 50)) {
+                } else if (clicked == exit_button) {
                     quit = true;
                 }
             }
-        }
+        } while (SDL_PollEvent(&event));
     }
 
-    // Cleanup
+    // Cleanup, once any job still running has finished with game and its completion has run
+    pool_shutdown();
+    while (SDL_PollEvent(&event)) {
+        event_invalidates_screen(&event);
+    }
+    leaderboard_free(&game);
+    attempt_history_close(&game);
+    score_log_close(&game);
+    journal_close(&game);
+    question_bank_free(&game);
+    player_registry_free(&game);
     close_sdl(window, renderer, font);
-    return 0;
+    return status;
 }
 
-bool init_sdl(SDL_Window** window, SDL_Renderer** renderer, TTF_Font** font) {
+bool init_sdl(SDL_Window** window, SDL_Renderer** renderer) {
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
         printf("SDL could not initialize! SDL_Error: %s\n", SDL_GetError());
         return false;
@@ -193,20 +984,26 @@ bool init_sdl(SDL_Window** window, SDL_Renderer** renderer, TTF_Font** font) {
         return false;
     }
 
+    return true;
+}
+
+TTF_Font* open_font(void) {
     // Try to load a common font
-    *font = TTF_OpenFont("arial.ttf", 24);
-    if (*font == NULL) {
-        *font = TTF_OpenFont("dejavu-fonts-ttf-2.37/ttf/DejaVuSans.ttf", 24);
-        if (*font == NULL) {
+    TTF_Font* font = TTF_OpenFont("arial.ttf", 24);
+    if (font == NULL) {
+        font = TTF_OpenFont("dejavu-fonts-ttf-2.37/ttf/DejaVuSans.ttf", 24);
+        if (font == NULL) {
             printf("Failed to load font! TTF_Error: %s\n", TTF_GetError());
-            return false;
         }
     }
-
-    return true;
+    return font;
 }
 
 void close_sdl(SDL_Window* window, SDL_Renderer* renderer, TTF_Font* font) {
+    // Let queued saves reach the disk before SDL goes away
+    io_shutdown();
+    text_cache_clear(&text_cache);
+    glyph_atlas_destroy(&glyph_atlas);
     if (font) TTF_CloseFont(font);
     if (renderer) SDL_DestroyRenderer(renderer);
     if (window) SDL_DestroyWindow(window);
@@ -214,1381 +1011,5390 @@ void close_sdl(SDL_Window* window, SDL_Renderer* renderer, TTF_Font* font) {
     SDL_Quit();
 }
 
-void render_text(SDL_Renderer* renderer, TTF_Font* font, const char* text, int x, int y, SDL_Color color) {
-    if (text == NULL || strlen(text) == 0) {
-        return;
+bool glyph_atlas_build(GlyphAtlas* atlas, SDL_Renderer* renderer, TTF_Font* font) {
+    SDL_Color WHITE = {255, 255, 255, 255};
+    SDL_Surface* glyph_surfaces[ATLAS_GLYPH_COUNT] = {0};
+    
+    memset(atlas, 0, sizeof(GlyphAtlas));
+    atlas->renderer = renderer;
+    atlas->font = font;
+    atlas->width = ATLAS_WIDTH;
+    atlas->line_height = TTF_FontHeight(font);
+    
+    // Rasterize each glyph once and pack it into rows
+    int pen_x = 0, pen_y = 0, row_height = 0;
+    for (int i = 0; i < ATLAS_GLYPH_COUNT; i++) {
+        Uint16 ch = (Uint16)(ATLAS_FIRST_GLYPH + i);
+        int minx, maxx, miny, maxy, advance;
+        if (TTF_GlyphMetrics(font, ch, &minx, &maxx, &miny, &maxy, &advance) != 0) {
+            continue;
+        }
+        atlas->advances[i] = advance;
+        
+        // Blank glyphs such as space have no surface, only an advance
+        SDL_Surface* surface = TTF_RenderGlyph_Blended(font, ch, WHITE);
+        if (surface == NULL) {
+            continue;
+        }
+        
+        if (pen_x + surface->w > ATLAS_WIDTH) {
+            pen_x = 0;
+            pen_y += row_height + 1;
+            row_height = 0;
+        }
+        atlas->glyphs[i] = (SDL_Rect){pen_x, pen_y, surface->w, surface->h};
+        pen_x += surface->w + 1;
+        if (surface->h > row_height) row_height = surface->h;
+        glyph_surfaces[i] = surface;
     }
+    atlas->height = pen_y + row_height;
     
-    SDL_Surface* surface = TTF_RenderText_Solid(font, text, color);
-    if (surface == NULL) {
-        return;
+    // Copy the glyphs into one sheet and upload it as a single texture
+    SDL_Surface* sheet = NULL;
+    if (atlas->height > 0) {
+        sheet = SDL_CreateRGBSurfaceWithFormat(0, atlas->width, atlas->height, 32, SDL_PIXELFORMAT_RGBA32);
+    }
+    if (sheet != NULL) {
+        for (int i = 0; i < ATLAS_GLYPH_COUNT; i++) {
+            if (glyph_surfaces[i] == NULL) continue;
+            SDL_Rect dest = atlas->glyphs[i];
+            SDL_SetSurfaceBlendMode(glyph_surfaces[i], SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(glyph_surfaces[i], NULL, sheet, &dest);
+        }
+        atlas->texture = SDL_CreateTextureFromSurface(renderer, sheet);
+        SDL_FreeSurface(sheet);
     }
     
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (texture == NULL) {
-        SDL_FreeSurface(surface);
-        return;
+    for (int i = 0; i < ATLAS_GLYPH_COUNT; i++) {
+        if (glyph_surfaces[i]) SDL_FreeSurface(glyph_surfaces[i]);
     }
     
-    SDL_Rect dest = {x, y, surface->w, surface->h};
-    SDL_RenderCopy(renderer, texture, NULL, &dest);
+    if (atlas->texture == NULL) {
+        printf("Glyph atlas could not be created! SDL_Error: %s\n", SDL_GetError());
+        return false;
+    }
+    SDL_SetTextureBlendMode(atlas->texture, SDL_BLENDMODE_BLEND);
     
-    SDL_FreeSurface(surface);
-    SDL_DestroyTexture(texture);
+    // Two triangles per glyph quad
+    for (int q = 0; q < ATLAS_BATCH_GLYPHS; q++) {
+        int* idx = &atlas->indices[q * 6];
+        idx[0] = q * 4;     idx[1] = q * 4 + 1; idx[2] = q * 4 + 2;
+        idx[3] = q * 4 + 2; idx[4] = q * 4 + 3; idx[5] = q * 4;
+    }
+    
+    return true;
 }
 
-void render_button(SDL_Renderer* renderer, TTF_Font* font, const char* text, int x, int y, int w, int h, SDL_Color bg_color, SDL_Color text_color) {
-    // Draw button background
-    SDL_Rect button_rect = {x, y, w, h};
-    SDL_SetRenderDrawColor(renderer, bg_color.r, bg_color.g, bg_color.b, bg_color.a);
-    SDL_RenderFillRect(renderer, &button_rect);
-    
-    // Draw button border
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-    SDL_RenderDrawRect(renderer, &button_rect);
+void glyph_atlas_destroy(GlyphAtlas* atlas) {
+    if (atlas->texture) SDL_DestroyTexture(atlas->texture);
+    memset(atlas, 0, sizeof(GlyphAtlas));
+}
+
+GlyphAtlas* get_glyph_atlas(SDL_Renderer* renderer, TTF_Font* font) {
+    if (glyph_atlas.texture && glyph_atlas.renderer == renderer && glyph_atlas.font == font) {
+        return &glyph_atlas;
+    }
     
-    // Render button text (centered)
-    if (text && strlen(text) > 0) {
-        int text_width, text_height;
-        if (TTF_SizeText(font, text, &text_width, &text_height) == 0) {
-            render_text(renderer, font, text, x + (w - text_width)/2, y + (h - text_height)/2, text_color);
-        }
+    // First use, or the font/renderer changed: rebuild
+    glyph_atlas_destroy(&glyph_atlas);
+    if (!glyph_atlas_build(&glyph_atlas, renderer, font)) {
+        glyph_atlas_destroy(&glyph_atlas);
+        return NULL;
     }
+    return &glyph_atlas;
 }
 
-bool is_button_clicked(int mouse_x, int mouse_y, int btn_x, int btn_y, int btn_w, int btn_h) {
-    return (mouse_x >= btn_x && mouse_x <= btn_x + btn_w &&
-            mouse_y >= btn_y && mouse_y <= btn_y + btn_h);
+int glyph_atlas_text_width(const GlyphAtlas* atlas, const char* text) {
+    int width = 0;
+    for (const unsigned char* p = (const unsigned char*)text; *p; p++) {
+        if (*p >= ATLAS_FIRST_GLYPH) {
+            width += atlas->advances[*p - ATLAS_FIRST_GLYPH];
+        }
+    }
+    return width;
 }
 
-void get_text_input(SDL_Renderer* renderer, TTF_Font* font, char* buffer, int max_length, const char* prompt) {
-    SDL_Color WHITE = {255, 255, 255, 255};
-    SDL_Color BLACK = {0, 0, 0, 255};
-    
-    memset(buffer, 0, max_length);
-    char temp_buffer[MAX_NAME_LENGTH] = {0};
-    
-    SDL_StartTextInput();
-    bool done = false;
+void glyph_atlas_draw(GlyphAtlas* atlas, const char* text, int x, int y, SDL_Color color) {
+    SDL_Vertex vertices[ATLAS_BATCH_GLYPHS * 4];
+    float inv_w = 1.0f / atlas->width;
+    float inv_h = 1.0f / atlas->height;
+    int quads = 0;
+    int pen_x = x;
     
-    while (!done) {
-        SDL_Event event;
-        while (SDL_PollEvent(&event)) {
-            switch (event.type) {
-                case SDL_KEYDOWN:
-                    if (event.key.keysym.sym == SDLK_RETURN) {
-                        strcpy(buffer, temp_buffer);
-                        done = true;
-                    } else if (event.key.keysym.sym == SDLK_BACKSPACE && strlen(temp_buffer) > 0) {
-                        temp_buffer[strlen(temp_buffer) - 1] = '\0';
-                    }
-                    break;
-                
-                case SDL_TEXTINPUT:
-                    if (strlen(temp_buffer) < max_length - 1) {
-                        strcat(temp_buffer, event.text.text);
-                    }
-                    break;
-                
-                case SDL_QUIT:
-                    done = true;
-                    break;
+    for (const unsigned char* p = (const unsigned char*)text; *p; p++) {
+        if (*p < ATLAS_FIRST_GLYPH) continue;
+        int i = *p - ATLAS_FIRST_GLYPH;
+        const SDL_Rect* src = &atlas->glyphs[i];
+        
+        if (src->w > 0) {
+            float x0 = (float)pen_x, y0 = (float)y;
+            float x1 = x0 + src->w, y1 = y0 + src->h;
+            float u0 = src->x * inv_w, v0 = src->y * inv_h;
+            float u1 = (src->x + src->w) * inv_w, v1 = (src->y + src->h) * inv_h;
+            
+            // Vertex color tints the white glyphs
+            SDL_Vertex* v = &vertices[quads * 4];
+            v[0] = (SDL_Vertex){{x0, y0}, color, {u0, v0}};
+            v[1] = (SDL_Vertex){{x1, y0}, color, {u1, v0}};
+            v[2] = (SDL_Vertex){{x1, y1}, color, {u1, v1}};
+            v[3] = (SDL_Vertex){{x0, y1}, color, {u0, v1}};
+            
+            // Flush a full batch
+            if (++quads == ATLAS_BATCH_GLYPHS) {
+                SDL_RenderGeometry(atlas->renderer, atlas->texture, vertices, quads * 4, atlas->indices, quads * 6);
+                quads = 0;
             }
         }
-        
-        // Clear screen
-        SDL_SetRenderDrawColor(renderer, 0, 0, 128, 255);
-        SDL_RenderClear(renderer);
-        
-        // Render input prompt
-        render_text(renderer, font, prompt, SCREEN_WIDTH/2 - 100, 200, WHITE);
-        
-        // Render current input
-        render_text(renderer, font, temp_buffer, SCREEN_WIDTH/2 - 100, 250, WHITE);
-        
-        // Render instruction
-        render_text(renderer, font, "Press Enter when done", SCREEN_WIDTH/2 - 100, 300, WHITE);
-        
-        SDL_RenderPresent(renderer);
+        pen_x += atlas->advances[i];
     }
     
-    SDL_StopTextInput();
+    if (quads > 0) {
+        SDL_RenderGeometry(atlas->renderer, atlas->texture, vertices, quads * 4, atlas->indices, quads * 6);
+    }
 }
 
-void render_timer(SDL_Renderer* renderer, TTF_Font* font, int time_remaining, int x, int y) {
-    SDL_Color WHITE = {255, 255, 255, 255};
-    SDL_Color RED = {255, 0, 0, 255};
-    
-    char timer_text[20];
-    snprintf(timer_text, sizeof(timer_text), "Time: %d", time_remaining);
-    
-    // Use red color when time is running low
-    SDL_Color color = (time_remaining <= 5) ? RED : WHITE;
+void text_cache_init(TextCache* cache, SDL_Renderer* renderer, size_t byte_budget) {
+    memset(cache, 0, sizeof(TextCache));
+    cache->renderer = renderer;
+    cache->byte_budget = byte_budget;
+    cache->lru_head = -1;
+    cache->lru_tail = -1;
+    for (int i = 0; i < TEXT_CACHE_BUCKETS; i++) {
+        cache->buckets[i] = -1;
+    }
     
-    render_text(renderer, font, timer_text, x, y, color);
+    // Chain every entry into the free list
+    for (int i = 0; i < TEXT_CACHE_MAX_ENTRIES; i++) {
+        cache->entries[i].hash_next = (i + 1 < TEXT_CACHE_MAX_ENTRIES) ? i + 1 : -1;
+    }
+    cache->free_head = 0;
 }
 
-int count_questions_by_difficulty(GameState* game, int difficulty) {
-    int count = 0;
-    for (int i = 0; i < game->total_questions; i++) {
-        if (game->questions[i].difficulty == difficulty) {
-            count++;
+void text_cache_clear(TextCache* cache) {
+    for (int i = 0; i < TEXT_CACHE_MAX_ENTRIES; i++) {
+        if (cache->entries[i].texture) SDL_DestroyTexture(cache->entries[i].texture);
+    }
+    memset(cache, 0, sizeof(TextCache));
+}
+
+Uint32 text_cache_hash(TTF_Font* font, const char* text, SDL_Color color) {
+    // The text, then the color and font continue the same hash
+    Uint32 rgba = ((Uint32)color.r << 24) | ((Uint32)color.g << 16) | ((Uint32)color.b << 8) | color.a;
+    Uint32 hash = fnv1a(FNV_OFFSET_BASIS, text, strlen(text));
+    hash = fnv1a(hash, &rgba, sizeof(rgba));
+    return fnv1a(hash, &font, sizeof(font));
+}
+
+void text_cache_lru_unlink(TextCache* cache, int index) {
+    TextCacheEntry* entry = &cache->entries[index];
+    if (entry->lru_prev != -1) cache->entries[entry->lru_prev].lru_next = entry->lru_next;
+    else cache->lru_head = entry->lru_next;
+    if (entry->lru_next != -1) cache->entries[entry->lru_next].lru_prev = entry->lru_prev;
+    else cache->lru_tail = entry->lru_prev;
+}
+
+void text_cache_lru_push_front(TextCache* cache, int index) {
+    TextCacheEntry* entry = &cache->entries[index];
+    entry->lru_prev = -1;
+    entry->lru_next = cache->lru_head;
+    if (cache->lru_head != -1) cache->entries[cache->lru_head].lru_prev = index;
+    cache->lru_head = index;
+    if (cache->lru_tail == -1) cache->lru_tail = index;
+}
+
+void text_cache_evict_lru(TextCache* cache) {
+    int index = cache->lru_tail;
+    if (index == -1) {
+        return;
+    }
+    TextCacheEntry* entry = &cache->entries[index];
+    
+    // Remove from its hash bucket
+    int* link = &cache->buckets[entry->hash % TEXT_CACHE_BUCKETS];
+    while (*link != index) {
+        link = &cache->entries[*link].hash_next;
+    }
+    *link = entry->hash_next;
+    
+    text_cache_lru_unlink(cache, index);
+    SDL_DestroyTexture(entry->texture);
+    cache->bytes_used -= entry->bytes;
+    cache->count--;
+    cache->evictions++;
+    
+    entry->texture = NULL;
+    entry->hash_next = cache->free_head;
+    cache->free_head = index;
+}
+
+void text_cache_set_budget(TextCache* cache, size_t byte_budget) {
+    cache->byte_budget = byte_budget;
+    while (cache->bytes_used > cache->byte_budget && cache->lru_tail != -1) {
+        text_cache_evict_lru(cache);
+    }
+}
+
+TextCacheEntry* text_cache_get(TextCache* cache, TTF_Font* font, const char* text, SDL_Color color) {
+    // Lines longer than an entry can hold are not cached
+    if (strlen(text) >= MAX_QUESTION_LENGTH) {
+        return NULL;
+    }
+    
+    Uint32 hash = text_cache_hash(font, text, color);
+    int bucket = hash % TEXT_CACHE_BUCKETS;
+    for (int i = cache->buckets[bucket]; i != -1; i = cache->entries[i].hash_next) {
+        TextCacheEntry* entry = &cache->entries[i];
+        if (entry->hash == hash && entry->font == font &&
+            entry->color.r == color.r && entry->color.g == color.g &&
+            entry->color.b == color.b && entry->color.a == color.a &&
+            strcmp(entry->text, text) == 0) {
+            cache->hits++;
+            if (cache->lru_head != i) {
+                text_cache_lru_unlink(cache, i);
+                text_cache_lru_push_front(cache, i);
+            }
+            return entry;
         }
     }
-    return count;
+    cache->misses++;
+    
+    // Render the whole line once so kerning is preserved
+    SDL_Surface* surface = TTF_RenderText_Blended(font, text, color);
+    if (surface == NULL) {
+        return NULL;
+    }
+    size_t bytes = (size_t)surface->w * surface->h * 4;
+    if (bytes > cache->byte_budget) {
+        SDL_FreeSurface(surface);
+        return NULL;
+    }
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(cache->renderer, surface);
+    int w = surface->w, h = surface->h;
+    SDL_FreeSurface(surface);
+    if (texture == NULL) {
+        return NULL;
+    }
+    
+    // Make room under the byte budget and the entry limit
+    while (cache->lru_tail != -1 &&
+           (cache->bytes_used + bytes > cache->byte_budget || cache->free_head == -1)) {
+        text_cache_evict_lru(cache);
+    }
+    
+    int index = cache->free_head;
+    TextCacheEntry* entry = &cache->entries[index];
+    cache->free_head = entry->hash_next;
+    
+    entry->font = font;
+    entry->color = color;
+    strcpy(entry->text, text);
+    entry->hash = hash;
+    entry->texture = texture;
+    entry->w = w;
+    entry->h = h;
+    entry->bytes = bytes;
+    entry->hash_next = cache->buckets[bucket];
+    cache->buckets[bucket] = index;
+    text_cache_lru_push_front(cache, index);
+    cache->bytes_used += bytes;
+    cache->count++;
+    
+    return entry;
 }
 
-void master_login(SDL_Renderer* renderer, TTF_Font* font, GameState* game) {
-    SDL_Color WHITE = {255, 255, 255, 255};
-    SDL_Color BLUE = {0, 0, 128, 255};
-    SDL_Color LIGHT_BLUE = {100, 149, 237, 255};
-    SDL_Color RED = {255, 0, 0, 255};
+TextCache* get_text_cache(SDL_Renderer* renderer) {
+    if (text_cache.renderer != renderer) {
+        // First use, or the renderer changed: start over
+        text_cache_clear(&text_cache);
+        text_cache_init(&text_cache, renderer, TEXT_CACHE_DEFAULT_BUDGET);
+    }
+    return &text_cache;
+}
+
+void render_text(SDL_Renderer* renderer, TTF_Font* font, const char* text, int x, int y, SDL_Color color) {
+    if (text == NULL || text[0] == '\0') {
+        return;
+    }
     
-    bool quit = false;
-    SDL_Event event;
+    // Reuse the cached line texture when there is one
+    TextCacheEntry* entry = text_cache_get(get_text_cache(renderer), font, text, color);
+    if (entry != NULL) {
+        SDL_Rect dest = {x, y, entry->w, entry->h};
+        SDL_RenderCopy(renderer, entry->texture, NULL, &dest);
+        return;
+    }
     
-    // Password protection
-    char password[MAX_NAME_LENGTH] = "admin123"; // Default password
-    char input[MAX_NAME_LENGTH] = {0};
+    render_dynamic_text(renderer, font, text, x, y, color);
+}
+
+void render_dynamic_text(SDL_Renderer* renderer, TTF_Font* font, const char* text, int x, int y, SDL_Color color) {
+    if (text == NULL || text[0] == '\0') {
+        return;
+    }
     
-    // Get password input
-    get_text_input(renderer, font, input, MAX_NAME_LENGTH, "Enter Master Password:");
+    // Draw from the glyph atlas when available
+    GlyphAtlas* atlas = get_glyph_atlas(renderer, font);
+    if (atlas != NULL) {
+        glyph_atlas_draw(atlas, text, x, y, color);
+        return;
+    }
     
-    // Check password
-    if (strcmp(input, password) != 0) {
-        SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
-        SDL_RenderClear(renderer);
-        render_text(renderer, font, "Incorrect Password!", SCREEN_WIDTH/2 - 100, 250, RED);
-        SDL_RenderPresent(renderer);
-        SDL_Delay(1500);
+    SDL_Surface* surface = TTF_RenderText_Solid(font, text, color);
+    if (surface == NULL) {
         return;
     }
     
-    while (!quit) {
-        SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
-        SDL_RenderClear(renderer);
-        
-        // Title
-        render_text(renderer, font, "MASTER MODE", SCREEN_WIDTH/2 - 100, 100, WHITE);
-        
-        // Add Questions Button
-        render_button(renderer, font, "Add Questions", SCREEN_WIDTH/2 - 100, 200, 200, 50, LIGHT_BLUE, WHITE);
-        
-        // View Questions Button
-        render_button(renderer, font, "View Questions", SCREEN_WIDTH/2 - 100, 300, 200, 50, LIGHT_BLUE, WHITE);
-        
-        // View Player History Button
-        render_button(renderer, font, "View Player History", SCREEN_WIDTH/2 - 100, 400, 200, 50, LIGHT_BLUE, WHITE);
-        
-        // Back Button
-        render_button(renderer, font, "Back to Menu", SCREEN_WIDTH/2 - 100, 500, 200, 50, LIGHT_BLUE, WHITE);
-        
-        SDL_RenderPresent(renderer);
-        
-        while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_QUIT) {
-                quit = true;
-                break;
-            }
-            
-            if (event.type == SDL_MOUSEBUTTONDOWN) {
-                int mouse_x, mouse_y;
-                SDL_GetMouseState(&mouse_x, &mouse_y);
-                
-                // Add Questions Button
-                if (is_button_clicked(mouse_x, mouse_y, SCREEN_WIDTH/2 - 100, 200, 200, 50)) {
-                    add_questions(renderer, font, game);
-                }
-                
-                // View Questions Button
-                if (is_button_clicked(mouse_x, mouse_y, SCREEN_WIDTH/2 - 100, 300, 200, 50)) {
-                    view_questions(renderer, font, game);
-                }
-                
-                // View Player History Button
-                if (is_button_clicked(mouse_x, mouse_y, SCREEN_WIDTH/2 - 100, 400, 200, 50)) {
-                    show_player_history(renderer, font, game);
-                }
-                
-                // Back Button
-                if (is_button_clicked(mouse_x, mouse_y, SCREEN_WIDTH/2 - 100, 500, 200, 50)) {
-                    quit = true;
-                }
-            }
-        }
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    if (texture == NULL) {
+        SDL_FreeSurface(surface);
+        return;
     }
+    
+    SDL_Rect dest = {x, y, surface->w, surface->h};
+    SDL_RenderCopy(renderer, texture, NULL, &dest);
+    
+    SDL_FreeSurface(surface);
+    SDL_DestroyTexture(texture);
 }
 
-void student_login(SDL_Renderer* renderer, TTF_Font* font, GameState* game) {
-    SDL_Color WHITE = {255, 255, 255, 255};
-    SDL_Color BLUE = {0, 0, 128, 255};
-    SDL_Color LIGHT_BLUE = {100, 149, 237, 255};
-    SDL_Color RED = {255, 0, 0, 255};
+void render_button(SDL_Renderer* renderer, TTF_Font* font, const char* text, int x, int y, int w, int h, SDL_Color bg_color, SDL_Color text_color) {
+    // Draw button background
+    SDL_Rect button_rect = {x, y, w, h};
+    SDL_SetRenderDrawColor(renderer, bg_color.r, bg_color.g, bg_color.b, bg_color.a);
+    SDL_RenderFillRect(renderer, &button_rect);
     
-    // Get student name
-    get_text_input(renderer, font, game->current_player, MAX_NAME_LENGTH, "Enter your name:");
+    // Draw button border
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    SDL_RenderDrawRect(renderer, &button_rect);
     
-    bool quit = false;
-    SDL_Event event;
+    // Render button text (centered)
+    if (text && text[0] != '\0') {
+        render_centered_text(renderer, font, text, button_rect, text_color);
+    }
+}
+
+void render_centered_text(SDL_Renderer* renderer, TTF_Font* font, const char* text, SDL_Rect rect, SDL_Color color) {
+    int text_width, text_height;
+    TextCacheEntry* entry = text_cache_get(get_text_cache(renderer), font, text, color);
+    GlyphAtlas* atlas = NULL;
+    if (entry != NULL) {
+        SDL_Rect dest = {rect.x + (rect.w - entry->w)/2, rect.y + (rect.h - entry->h)/2, entry->w, entry->h};
+        SDL_RenderCopy(renderer, entry->texture, NULL, &dest);
+    } else if ((atlas = get_glyph_atlas(renderer, font)) != NULL) {
+        // Measure from the atlas advances instead of asking TTF every frame
+        text_width = glyph_atlas_text_width(atlas, text);
+        text_height = atlas->line_height;
+        glyph_atlas_draw(atlas, text, rect.x + (rect.w - text_width)/2, rect.y + (rect.h - text_height)/2, color);
+    } else if (TTF_SizeText(font, text, &text_width, &text_height) == 0) {
+        render_dynamic_text(renderer, font, text, rect.x + (rect.w - text_width)/2, rect.y + (rect.h - text_height)/2, color);
+    }
+}
+
+bool is_button_clicked(int mouse_x, int mouse_y, int btn_x, int btn_y, int btn_w, int btn_h) {
+    return (mouse_x >= btn_x && mouse_x <= btn_x + btn_w &&
+            mouse_y >= btn_y && mouse_y <= btn_y + btn_h);
+}
+
+int add_label(WidgetList* list, const char* text, int x, int y, SDL_Color color) {
+    if (list->count >= MAX_WIDGETS) {
+        return -1;
+    }
+    Widget* widget = &list->items[list->count];
+    widget->rect = (SDL_Rect){x, y, 0, 0};
+    widget->type = WIDGET_LABEL;
+    widget->visible = true;
+    widget->text = text;
+    widget->text_color = color;
+    return list->count++;
+}
+
+int add_button(WidgetList* list, const char* text, int x, int y, int w, int h, SDL_Color bg_color, SDL_Color text_color) {
+    if (list->count >= MAX_WIDGETS) {
+        return -1;
+    }
+    Widget* widget = &list->items[list->count];
+    widget->rect = (SDL_Rect){x, y, w, h};
+    widget->type = WIDGET_BUTTON;
+    widget->visible = true;
+    widget->text = text;
+    widget->bg_color = bg_color;
+    widget->text_color = text_color;
+    return list->count++;
+}
+
+void render_widgets(SDL_Renderer* renderer, TTF_Font* font, const WidgetList* list) {
+    SDL_Rect borders[MAX_WIDGETS];
+    int border_count = 0;
     
-    while (!quit) {
-        SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
-        SDL_RenderClear(renderer);
-        
-        char welcome[100];
-        sprintf(welcome, "Welcome, %s!", game->current_player);
-        render_text(renderer, font, welcome, SCREEN_WIDTH/2 - 100, 100, WHITE);
-        
-        // Difficulty Selection Buttons
-        int easy_count = count_questions_by_difficulty(game, DIFFICULTY_EASY);
-        int medium_count = count_questions_by_difficulty(game, DIFFICULTY_MEDIUM);
-        int hard_count = count_questions_by_difficulty(game, DIFFICULTY_HARD);
-        
-        render_button(renderer, font, "Easy Quiz", SCREEN_WIDTH/2 - 100, 200, 200, 50, 
-                     easy_count > 0 ? LIGHT_BLUE : RED, WHITE);
-        render_text(renderer, font, easy_count > 0 ? "" : "No questions available", 
-                   SCREEN_WIDTH/2 + 120, 215, WHITE);
-        
-        render_button(renderer, font, "Medium Quiz", SCREEN_WIDTH/2 - 100, 300, 200, 50, 
-                     medium_count > 0 ? LIGHT_BLUE : RED, WHITE);
-        render_text(renderer, font, medium_count > 0 ? "" : "No questions available", 
-                   SCREEN_WIDTH/2 + 120, 315, WHITE);
-        
-        render_button(renderer, font, "Hard Quiz", SCREEN_WIDTH/2 - 100, 400, 200, 50, 
-                     hard_count > 0 ? LIGHT_BLUE : RED, WHITE);
-        render_text(renderer, font, hard_count > 0 ? "" : "No questions available", 
-                   SCREEN_WIDTH/2 + 120, 415, WHITE);
+    // Button backgrounds first, then every border in one call
+    for (int i = 0; i < list->count; i++) {
+        const Widget* widget = &list->items[i];
+        if (!widget->visible || widget->type != WIDGET_BUTTON) continue;
+        SDL_SetRenderDrawColor(renderer, widget->bg_color.r, widget->bg_color.g, widget->bg_color.b, widget->bg_color.a);
+        SDL_RenderFillRect(renderer, &widget->rect);
+        borders[border_count++] = widget->rect;
+    }
+    if (border_count > 0) {
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+        SDL_RenderDrawRects(renderer, borders, border_count);
+    }
+    
+    // Text last so it is never covered by a background
+    for (int i = 0; i < list->count; i++) {
+        const Widget* widget = &list->items[i];
+        if (!widget->visible || widget->text == NULL || widget->text[0] == '\0') continue;
         
-        // View History Button
-        render_button(renderer, font, "View History", SCREEN_WIDTH/2 - 100, 500, 200, 50, LIGHT_BLUE, WHITE);
+        if (widget->type == WIDGET_LABEL) {
+            render_text(renderer, font, widget->text, widget->rect.x, widget->rect.y, widget->text_color);
+            continue;
+        }
         
-        // Back Button
-        render_button(renderer, font, "Back to Menu", SCREEN_WIDTH/2 - 100, 600, 200, 50, LIGHT_BLUE, WHITE);
+        render_centered_text(renderer, font, widget->text, widget->rect, widget->text_color);
+    }
+}
+
+int hit_test_widgets(const WidgetList* list, int mouse_x, int mouse_y) {
+    // Returns the index of the clicked button, or -1; stops at the first match
+    for (int i = 0; i < list->count; i++) {
+        const Widget* widget = &list->items[i];
+        if (widget->visible && widget->type == WIDGET_BUTTON &&
+            is_button_clicked(mouse_x, mouse_y, widget->rect.x, widget->rect.y, widget->rect.w, widget->rect.h)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool event_invalidates_screen(const SDL_Event* event) {
+    // Mouse motion and other unhandled events leave the frame unchanged.
+    // Every screen passes its events through here, so pool completions are delivered here too
+    switch (event->type) {
+        case POOL_EVENT:
+            pool_complete(event);
+            return true;
+        case SDL_QUIT:
+        case SDL_KEYDOWN:
+        case SDL_TEXTINPUT:
+        case SDL_MOUSEBUTTONDOWN:
+        case SDL_WINDOWEVENT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+int wait_modal(const ModalTarget* targets, int target_count, Uint32 timeout_ms) {
+    // Blocks until a target is clicked, the window is closed or timeout_ms
+    // passes (0 waits forever); the frame already on screen stays up
+    Uint32 deadline = SDL_GetTicks() + timeout_ms;
+    SDL_Event event;
+    
+    while (true) {
+        int got_event;
+        if (timeout_ms == 0) {
+            got_event = SDL_WaitEvent(&event);
+            if (!got_event) {
+                return MODAL_QUIT;
+            }
+        } else {
+            Sint32 remaining = (Sint32)(deadline - SDL_GetTicks());
+            if (remaining <= 0) {
+                return MODAL_TIMEOUT;
+            }
+            got_event = SDL_WaitEventTimeout(&event, remaining);
+            if (!got_event) {
+                continue;
+            }
+        }
         
-        SDL_RenderPresent(renderer);
+        if (event.type == POOL_EVENT) {
+            pool_complete(&event);
+            continue;
+        }
         
-        while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_QUIT) {
-                quit = true;
-                break;
+        if (event.type == SDL_QUIT) {
+            // A plain timed message must not swallow the quit meant for the screen below
+            if (target_count == 0) {
+                SDL_PushEvent(&event);
             }
+            return MODAL_QUIT;
+        }
+        
+        if (event.type == SDL_MOUSEBUTTONDOWN) {
+            int mouse_x, mouse_y;
+            SDL_GetMouseState(&mouse_x, &mouse_y);
             
-            if (event.type == SDL_MOUSEBUTTONDOWN) {
-                int mouse_x, mouse_y;
-                SDL_GetMouseState(&mouse_x, &mouse_y);
-                
-                // Easy Quiz
-                if (is_button_clicked(mouse_x, mouse_y, SCREEN_WIDTH/2 - 100, 200, 200, 50) && 
-                    count_questions_by_difficulty(game, DIFFICULTY_EASY) > 0) {
-                    start_quiz(renderer, font, game, DIFFICULTY_EASY);
-                    show_results(renderer, font, game, DIFFICULTY_EASY);
-                }
-                
-                // Medium Quiz
-                if (is_button_clicked(mouse_x, mouse_y, SCREEN_WIDTH/2 - 100, 300, 200, 50) && 
-                    count_questions_by_difficulty(game, DIFFICULTY_MEDIUM) > 0) {
-                    start_quiz(renderer, font, game, DIFFICULTY_MEDIUM);
-                    show_results(renderer, font, game, DIFFICULTY_MEDIUM);
-                }
-                
-                // Hard Quiz
-                if (is_button_clicked(mouse_x, mouse_y, SCREEN_WIDTH/2 - 100, 400, 200, 50) && 
-                    count_questions_by_difficulty(game, DIFFICULTY_HARD) > 0) {
-                    start_quiz(renderer, font, game, DIFFICULTY_HARD);
-                    show_results(renderer, font, game, DIFFICULTY_HARD);
-                }
-                
-                // View History Button
-                if (is_button_clicked(mouse_x, mouse_y, SCREEN_WIDTH/2 - 100, 500, 200, 50)) {
-                    show_player_history(renderer, font, game);
-                }
-                
-                // Back Button
-                if (is_button_clicked(mouse_x, mouse_y, SCREEN_WIDTH/2 - 100, 600, 200, 50)) {
-                    quit = true;
+            // First matching target wins
+            for (int i = 0; i < target_count; i++) {
+                const ModalTarget* target = &targets[i];
+                if (is_button_clicked(mouse_x, mouse_y, target->x, target->y, target->w, target->h)) {
+                    if (target->on_click) {
+                        target->on_click(target->data);
+                    }
+                    return target->result;
                 }
             }
         }
     }
 }
 
-void start_quiz(SDL_Renderer* renderer, TTF_Font* font, GameState* game, int difficulty) {
-    SDL_Color WHITE = {255, 255, 255, 255};
-    SDL_Color BLUE = {0, 0, 128, 255};
-    SDL_Color LIGHT_BLUE = {100, 149, 237, 255};
-    SDL_Color GREEN = {0, 255, 0, 255};
-    SDL_Color RED = {255, 0, 0, 255};
+void show_toast(const char* text, SDL_Color color, Uint32 duration_ms) {
+    // Drop the oldest toast when the queue is full
+    if (toast_count == MAX_TOASTS) {
+        memmove(&toasts[0], &toasts[1], sizeof(Toast) * (MAX_TOASTS - 1));
+        toast_count--;
+    }
     
-    // Filter questions by difficulty
-    Question difficulty_questions[MAX_QUESTIONS];
-    int count = 0;
-    for (int i = 0; i < game->total_questions; i++) {
-        if (game->questions[i].difficulty == difficulty) {
-            difficulty_questions[count++] = game->questions[i];
+    Toast* toast = &toasts[toast_count++];
+    strncpy(toast->text, text, MAX_QUESTION_LENGTH - 1);
+    toast->text[MAX_QUESTION_LENGTH - 1] = '\0';
+    toast->color = color;
+    toast->expires_at = SDL_GetTicks() + duration_ms;
+}
+
+bool prune_toasts(void) {
+    // Returns true when a toast expired and the screen needs redrawing
+    Uint32 now = SDL_GetTicks();
+    int kept = 0;
+    for (int i = 0; i < toast_count; i++) {
+        if ((Sint32)(toasts[i].expires_at - now) > 0) {
+            toasts[kept++] = toasts[i];
         }
     }
+    bool changed = kept != toast_count;
+    toast_count = kept;
+    return changed;
+}
+
+void render_toasts(SDL_Renderer* renderer, TTF_Font* font) {
+    for (int i = 0; i < toast_count; i++) {
+        SDL_Rect box = {SCREEN_WIDTH/2 - 250, 5 + i * (TOAST_HEIGHT + 5), 500, TOAST_HEIGHT};
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderFillRect(renderer, &box);
+        SDL_SetRenderDrawColor(renderer, toasts[i].color.r, toasts[i].color.g, toasts[i].color.b, 255);
+        SDL_RenderDrawRect(renderer, &box);
+        render_text(renderer, font, toasts[i].text, box.x + 20, box.y + 7, toasts[i].color);
+    }
+}
+
+int toast_wait_timeout(int timeout_ms) {
+    // Wake up in time to take the next toast off the screen
+    Uint32 now = SDL_GetTicks();
+    for (int i = 0; i < toast_count; i++) {
+        Sint32 remaining = (Sint32)(toasts[i].expires_at - now);
+        if (remaining < 1) remaining = 1;
+        if (remaining < timeout_ms) timeout_ms = remaining;
+    }
+    return timeout_ms;
+}
+
+void get_text_input(SDL_Renderer* renderer, TTF_Font* font, char* buffer, int max_length, const char* prompt) {
+    SDL_Color WHITE = {255, 255, 255, 255};
+    SDL_Color BLACK = {0, 0, 0, 255};
     
-    // Shuffle questions
-    shuffle_questions(difficulty_questions, count);
+    // Input is edited in the caller's buffer, so it can be as long as max_length allows
+    memset(buffer, 0, max_length);
     
-    // Determine how many questions to ask (minimum of QUESTIONS_PER_LEVEL or available questions)
-    int questions_to_ask = (count < QUESTIONS_PER_LEVEL) ? count : QUESTIONS_PER_LEVEL;
-    int score = 0;
+    SDL_StartTextInput();
+    bool done = false;
+    bool redraw = true;
     
-    // Start quiz
-    for (int q = 0; q < questions_to_ask; q++) {
-        Question current_question = difficulty_questions[q];
-        bool answered = false;
-        int selected_option = -1;
-        
-        // Start timer for this question
-        game->question_start_time = SDL_GetTicks();
-        game->time_remaining = QUESTION_TIME;
-        
-        while (!answered && game->time_remaining > 0) {
-            // Calculate remaining time
-            Uint32 current_time = SDL_GetTicks();
-            game->time_remaining = QUESTION_TIME - (current_time - game->question_start_time) / 1000;
-            if (game->time_remaining < 0) game->time_remaining = 0;
-            
-            SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
+    while (!done) {
+        redraw |= prune_toasts();
+        if (redraw) {
+            // Clear screen
+            SDL_SetRenderDrawColor(renderer, 0, 0, 128, 255);
             SDL_RenderClear(renderer);
             
-            // Display question number
-            char question_num[50];
-            sprintf(question_num, "Question %d/%d", q + 1, questions_to_ask);
-            render_text(renderer, font, question_num, 50, 50, WHITE);
-            
-            // Display timer
-            render_timer(renderer, font, game->time_remaining, SCREEN_WIDTH - 150, 50);
-            
-            // Display question
-            render_text(renderer, font, current_question.question, 50, 100, WHITE);
+            // Render input prompt
+            render_text(renderer, font, prompt, SCREEN_WIDTH/2 - 100, 200, WHITE);
             
-            // Display options
-            for (int i = 0; i < MAX_OPTIONS; i++) {
-                char option_text[150];
-                sprintf(option_text, "%d. %s", i + 1, current_question.options[i]);
-                
-                // Highlight selected option
-                SDL_Color bg_color = (selected_option == i) ? GREEN : LIGHT_BLUE;
-                render_button(renderer, font, option_text, 100, 200 + i * 80, 600, 50, bg_color, WHITE);
-            }
+            // Render current input
+            render_dynamic_text(renderer, font, buffer, SCREEN_WIDTH/2 - 100, 250, WHITE);
             
-            // Submit button
-            if (selected_option != -1) {
-                render_button(renderer, font, "Submit Answer", SCREEN_WIDTH/2 - 100, 550, 200, 50, GREEN, WHITE);
-            }
+            // Render instruction
+            render_text(renderer, font, "Press Enter when done", SCREEN_WIDTH/2 - 100, 300, WHITE);
             
+            render_toasts(renderer, font);
             SDL_RenderPresent(renderer);
-            
-            SDL_Event event;
-            while (SDL_PollEvent(&event)) {
-                if (event.type == SDL_QUIT) {
-                    return;
-                }
-                
-                if (event.type == SDL_MOUSEBUTTONDOWN) {
-                    int mouse_x, mouse_y;
-                    SDL_GetMouseState(&mouse_x, &mouse_y);
-                    
-                    // Check option buttons
-                    for (int i = 0; i < MAX_OPTIONS; i++) {
-                        if (is_button_clicked(mouse_x, mouse_y, 100, 200 + i * 80, 600, 50)) {
-                            selected_option = i;
-                        }
-                    }
-                    
-                    // Submit button
-                    if (selected_option != -1 && is_button_clicked(mouse_x, mouse_y, SCREEN_WIDTH/2 - 100, 550, 200, 50)) {
-                        answered = true;
-                        
-                        // Check answer
-                        if (selected_option == current_question.correct_option) {
-                            score += 5; // Correct answer: +5 points
-                        } else {
-                            score -= 1; // Incorrect answer: -1 point
-                        }
-                    }
-                }
-            }
+            redraw = false;
         }
         
-        // Time's up
-        if (!answered && game->time_remaining <= 0) {
-            SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
-            SDL_RenderClear(renderer);
-            render_text(renderer, font, "Time's up!", SCREEN_WIDTH/2 - 100, 250, RED);
-            
-            // Show correct answer
-            char correct_answer[100];
-            sprintf(correct_answer, "Correct answer: %d", current_question.correct_option + 1);
-            render_text(renderer, font, correct_answer, SCREEN_WIDTH/2 - 100, 300, GREEN);
-            
-            SDL_RenderPresent(renderer);
-            SDL_Delay(2000);
+        SDL_Event event;
+        
+        // Sleep until input arrives instead of redrawing an idle screen
+        if (!SDL_WaitEventTimeout(&event, toast_wait_timeout(IDLE_WAIT_MS))) {
+            continue;
         }
+        do {
+            if (event_invalidates_screen(&event)) {
+                redraw = true;
+            }
+            
+            switch (event.type) {
+                case SDL_KEYDOWN:
+                    if (event.key.keysym.sym == SDLK_RETURN) {
+                        done = true;
+                    } else if (event.key.keysym.sym == SDLK_BACKSPACE && strlen(buffer) > 0) {
+                        buffer[strlen(buffer) - 1] = '\0';
+                    }
+                    break;
+                
+                case SDL_TEXTINPUT:
+                    if (strlen(buffer) + strlen(event.text.text) < (size_t)max_length) {
+                        strcat(buffer, event.text.text);
+                    }
+                    break;
+                
+                case SDL_QUIT:
+                    // Closing the window gives back no input, only Enter accepts it
+                    buffer[0] = '\0';
+                    done = true;
+                    break;
+            }
+        } while (!done && SDL_PollEvent(&event));
     }
     
-    // Store score for this difficulty
-    game->current_score[difficulty] = score;
-    
-    // Add to player history
-    add_player_score(game, game->current_player, difficulty, score);
+    SDL_StopTextInput();
 }
 
-void show_results(SDL_Renderer* renderer, TTF_Font* font, GameState* game, int difficulty) {
+void render_timer(SDL_Renderer* renderer, TTF_Font* font, int time_remaining, int x, int y) {
     SDL_Color WHITE = {255, 255, 255, 255};
-    SDL_Color BLUE = {0, 0, 128, 255};
-    SDL_Color GREEN = {0, 255, 0, 255};
     SDL_Color RED = {255, 0, 0, 255};
     
-    const char* difficulty_str;
-    switch (difficulty) {
-        case DIFFICULTY_EASY: difficulty_str = "Easy"; break;
-        case DIFFICULTY_MEDIUM: difficulty_str = "Medium"; break;
-        case DIFFICULTY_HARD: difficulty_str = "Hard"; break;
-        default: difficulty_str = "Unknown";
+    char timer_text[20];
+    snprintf(timer_text, sizeof(timer_text), "Time: %d", time_remaining);
+    
+    // Use red color when time is running low
+    SDL_Color color = (time_remaining <= 5) ? RED : WHITE;
+    
+    render_dynamic_text(renderer, font, timer_text, x, y, color);
+}
+
+Uint32 string_pool_hash(const char* text) {
+    return fnv1a(FNV_OFFSET_BASIS, text, strlen(text));
+}
+
+bool string_pool_rehash(StringPool* pool, Uint32 slot_count) {
+    Uint32* slots = calloc(slot_count, sizeof(Uint32));
+    if (!slots) {
+        printf("Failed to grow string pool table to %u slots!\n", (unsigned)slot_count);
+        return false;
     }
     
-    SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
-    SDL_RenderClear(renderer);
+    // Rehash every stored string by walking the packed data, padding NULs are skipped
+    Uint32 mask = slot_count - 1;
+    const char* text;
+    for (Uint32 offset = 1; offset < pool->base_size + pool->used; offset += strlen(text) + 1) {
+        text = string_pool_get(pool, offset);
+        if (text[0] == '\0') {
+            continue;
+        }
+        Uint32 slot = string_pool_hash(text) & mask;
+        while (slots[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        slots[slot] = offset;
+    }
     
-    // Title
-    char title[100];
-    sprintf(title, "%s Quiz Results", difficulty_str);
-    render_text(renderer, font, title, SCREEN_WIDTH/2 - 100, 100, WHITE);
+    free(pool->slots);
+    pool->slots = slots;
+    pool->slot_count = slot_count;
+    return true;
+}
+
+Uint32 string_pool_intern(StringPool* pool, const char* text) {
+    // Offset 0 is always the empty string
+    if (text[0] == '\0') {
+        return 0;
+    }
     
-    // Player Name
-    char name_text[100];
-    sprintf(name_text, "Player: %s", game->current_player);
-    render_text(renderer, font, name_text, SCREEN_WIDTH/2 - 100, 150, WHITE);
+    // Keep the table under 3/4 full so probe chains stay short. A mapped base is
+    // only hashed here, on the first intern, so mapping a bank stays O(1).
+    if (!pool->slots && pool->base_size > 0) {
+        Uint32 slot_count = STRING_POOL_INITIAL_SLOTS;
+        const char* base_text;
+        pool->string_count = 0;
+        for (Uint32 offset = 1; offset < pool->base_size; offset += strlen(base_text) + 1) {
+            base_text = pool->base + offset;
+            pool->string_count += base_text[0] != '\0';
+        }
+        while ((pool->string_count + 1) * 4 > slot_count * 3) {
+            slot_count *= 2;
+        }
+        if (!string_pool_rehash(pool, slot_count)) {
+            return 0;
+        }
+    }
+    if ((pool->string_count + 1) * 4 > pool->slot_count * 3 &&
+        !string_pool_rehash(pool, pool->slot_count ? pool->slot_count * 2 : STRING_POOL_INITIAL_SLOTS)) {
+        return 0;
+    }
     
-    // Score
-    char score_text[50];
-    sprintf(score_text, "Score: %d", game->current_score[difficulty]);
-    render_text(renderer, font, score_text, SCREEN_WIDTH/2 - 100, 200, 
-               game->current_score[difficulty] >= 0 ? GREEN : RED);
+    // Identical text already in the pool is shared
+    Uint32 mask = pool->slot_count - 1;
+    Uint32 slot = string_pool_hash(text) & mask;
+    while (pool->slots[slot] != 0) {
+        if (strcmp(string_pool_get(pool, pool->slots[slot]), text) == 0) {
+            return pool->slots[slot];
+        }
+        slot = (slot + 1) & mask;
+    }
     
-    // Percentage
-    int questions_asked = count_questions_by_difficulty(game, difficulty) < QUESTIONS_PER_LEVEL ? 
-                         count_questions_by_difficulty(game, difficulty) : QUESTIONS_PER_LEVEL;
-    float percentage = (float)game->current_score[difficulty] / (questions_asked * 5) * 100;
-    char percentage_text[50];
-    sprintf(percentage_text, "Percentage: %.1f%%", percentage);
-    render_text(renderer, font, percentage_text, SCREEN_WIDTH/2 - 100, 250, WHITE);
+    size_t length = strlen(text) + 1;
+    if (pool->used + length > pool->capacity) {
+        Uint32 capacity = pool->capacity ? pool->capacity : STRING_POOL_INITIAL_CAPACITY;
+        while (pool->used + length + 1 > capacity) {
+            capacity *= 2;
+        }
+        char* data = realloc(pool->data, capacity);
+        if (!data) {
+            printf("Failed to grow string pool to %u bytes!\n", (unsigned)capacity);
+            return 0;
+        }
+        if (!pool->data && pool->base_size == 0) {
+            data[0] = '\0';
+            pool->used = 1;
+        }
+        pool->data = data;
+        pool->capacity = capacity;
+    }
     
-    // Back Button
-    render_button(renderer, font, "Continue", SCREEN_WIDTH/2 - 100, 350, 200, 50, GREEN, WHITE);
+    Uint32 offset = pool->base_size + pool->used;
+    memcpy(pool->data + pool->used, text, length);
+    pool->used += length;
+    pool->slots[slot] = offset;
+    pool->string_count++;
+    return offset;
+}
+
+Uint32 string_pool_find(const StringPool* pool, const char* text) {
+    // Like string_pool_intern but never adds the text; 0 if it is not in the pool
+    if (text[0] == '\0') {
+        return 0;
+    }
     
-    SDL_RenderPresent(renderer);
+    // A mapped base that has not been hashed yet is searched in place
+    if (!pool->slots) {
+        const char* base_text;
+        for (Uint32 offset = 1; offset < pool->base_size; offset += strlen(base_text) + 1) {
+            base_text = pool->base + offset;
+            if (strcmp(base_text, text) == 0) {
+                return offset;
+            }
+        }
+        return 0;
+    }
     
-    // Wait for back button
-    bool done = false;
+    Uint32 mask = pool->slot_count - 1;
+    Uint32 slot = string_pool_hash(text) & mask;
+    while (pool->slots[slot] != 0) {
+        if (strcmp(string_pool_get(pool, pool->slots[slot]), text) == 0) {
+            return pool->slots[slot];
+        }
+        slot = (slot + 1) & mask;
+    }
+    return 0;
+}
+
+bool string_pool_adopt(StringPool* pool, char* data, Uint32 size) {
+    // Take ownership of packed string data read from disk; it must start with the empty string
+    if (size == 0 || data[0] != '\0' || data[size - 1] != '\0') {
+        return false;
+    }
+    
+    Uint32 string_count = 0;
+    for (Uint32 offset = 1; offset < size; offset += strlen(data + offset) + 1) {
+        string_count += data[offset] != '\0';
+    }
+    
+    Uint32 slot_count = STRING_POOL_INITIAL_SLOTS;
+    while (string_count * 4 >= slot_count * 3) {
+        slot_count *= 2;
+    }
+    
+    string_pool_free(pool);
+    pool->data = data;
+    pool->used = size;
+    pool->capacity = size;
+    pool->string_count = string_count;
+    if (!string_pool_rehash(pool, slot_count)) {
+        pool->data = NULL;
+        string_pool_free(pool);
+        return false;
+    }
+    return true;
+}
+
+const char* string_pool_get(const StringPool* pool, Uint32 offset) {
+    // Out-of-range offsets (a damaged mapped bank) read as the empty string
+    if (offset < pool->base_size) {
+        return pool->base + offset;
+    }
+    offset -= pool->base_size;
+    return offset < pool->used ? pool->data + offset : "";
+}
+
+void string_pool_free(StringPool* pool) {
+    free(pool->data);
+    free(pool->slots);
+    memset(pool, 0, sizeof(StringPool));
+}
+
+bool question_bank_reserve(GameState* game, int capacity) {
+    if (capacity <= game->question_capacity) {
+        return true;
+    }
+    
+    int new_capacity = game->question_capacity ? game->question_capacity : INITIAL_QUESTION_CAPACITY;
+    while (new_capacity < capacity) {
+        new_capacity *= 2;
+    }
+    
+    Question* questions = realloc(game->questions, new_capacity * sizeof(Question));
+    if (!questions) {
+        printf("Failed to grow question bank to %d questions!\n", new_capacity);
+        return false;
+    }
+    game->questions = questions;
+    
+    int* bucket_slot = realloc(game->bucket_slot, new_capacity * sizeof(int));
+    if (!bucket_slot) {
+        printf("Failed to grow question bank to %d questions!\n", new_capacity);
+        return false;
+    }
+    game->bucket_slot = bucket_slot;
+    
+    // Each bucket can hold every question, so adds never need to grow them separately
+    for (int d = DIFFICULTY_EASY; d <= DIFFICULTY_HARD; d++) {
+        int* bucket = realloc(game->difficulty_index[d], new_capacity * sizeof(int));
+        if (!bucket) {
+            printf("Failed to grow question bank to %d questions!\n", new_capacity);
+            return false;
+        }
+        game->difficulty_index[d] = bucket;
+    }
+    
+    game->question_capacity = new_capacity;
+    return true;
+}
+
+bool question_bank_make_writable(GameState* game) {
+    // Banks loaded into memory are always writable, mapped ones become so on their first change
+    if (!game->mapped_file || game->overlaid) {
+        return true;
+    }
+    
+    bool* overlaid = calloc(game->mapped_count ? game->mapped_count : 1, sizeof(bool));
+    if (!overlaid || !question_bank_reserve(game, game->total_questions + 1)) {
+        printf("Failed to make the mapped question bank writable!\n");
+        free(overlaid);
+        return false;
+    }
+    
+    // Copy the bucket index out of the mapping; records and text stay mapped.
+    // Entries a damaged file got wrong are dropped rather than trusted for writes.
+    memset(game->bucket_slot, 0xFF, game->total_questions * sizeof(int));
+    for (int d = DIFFICULTY_EASY; d <= DIFFICULTY_HARD; d++) {
+        const int* mapped = game->mapped_index[d];
+        int kept = 0;
+        for (int i = 0; i < game->difficulty_count[d]; i++) {
+            int index = mapped[i];
+            if (index >= 0 && index < game->total_questions && game->bucket_slot[index] == -1 &&
+                game->mapped_questions[index].difficulty == d) {
+                game->bucket_slot[index] = kept;
+                game->difficulty_index[d][kept++] = index;
+            }
+        }
+        game->difficulty_count[d] = kept;
+    }
+    game->overlaid = overlaid;
+    return true;
+}
+
+void question_bank_free(GameState* game) {
+    free(game->questions);
+    free(game->bucket_slot);
+    for (int d = DIFFICULTY_EASY; d <= DIFFICULTY_HARD; d++) {
+        free(game->difficulty_index[d]);
+        game->difficulty_index[d] = NULL;
+        game->mapped_index[d] = NULL;
+        game->difficulty_count[d] = 0;
+    }
+    game->questions = NULL;
+    game->bucket_slot = NULL;
+    game->total_questions = 0;
+    game->question_capacity = 0;
+    string_pool_free(&game->strings);
+    
+#ifndef _WIN32
+    if (game->mapped_file) {
+        munmap((void*)game->mapped_file, game->mapped_size);
+    }
+#endif
+    free(game->overlaid);
+    game->mapped_file = NULL;
+    game->mapped_size = 0;
+    game->mapped_questions = NULL;
+    game->mapped_count = 0;
+    game->overlaid = NULL;
+}
+
+const Question* get_question(const GameState* game, int index) {
+    static const Question empty_question = {0};
+    
+    // Out-of-range indices (a damaged mapped bucket) read as an empty question
+    if (index < 0 || index >= game->total_questions) {
+        return &empty_question;
+    }
+    if (index < game->mapped_count && !(game->overlaid && game->overlaid[index])) {
+        return &game->mapped_questions[index];
+    }
+    return &game->questions[index];
+}
+
+Question* question_bank_edit(GameState* game, int index) {
+    // Copy-on-write: a mapped question is copied into the overlay before it changes
+    if (!question_bank_make_writable(game)) {
+        return NULL;
+    }
+    if (index < game->mapped_count && !game->overlaid[index]) {
+        game->questions[index] = game->mapped_questions[index];
+        game->overlaid[index] = true;
+    }
+    return &game->questions[index];
+}
+
+const int* question_bank_bucket(const GameState* game, int difficulty) {
+    if (game->mapped_file && !game->overlaid) {
+        return game->mapped_index[difficulty];
+    }
+    return game->difficulty_index[difficulty];
+}
+
+const char* question_text(const GameState* game, const Question* question) {
+    return string_pool_get(&game->strings, question->question);
+}
+
+const char* option_text(const GameState* game, const Question* question, int option) {
+    return string_pool_get(&game->strings, question->options[option]);
+}
+
+int question_bank_add(GameState* game, const Question* question) {
+    if (!question_bank_make_writable(game) || !question_bank_reserve(game, game->total_questions + 1)) {
+        return -1;
+    }
+    
+    int index = game->total_questions++;
+    game->questions[index] = *question;
+    
+    int d = question->difficulty;
+    if (d < DIFFICULTY_EASY || d > DIFFICULTY_HARD) {
+        game->bucket_slot[index] = -1;
+        return index;
+    }
+    game->bucket_slot[index] = game->difficulty_count[d];
+    game->difficulty_index[d][game->difficulty_count[d]++] = index;
+    return index;
+}
+
+bool question_bank_remove(GameState* game, int index) {
+    if (!question_bank_make_writable(game)) {
+        return false;
+    }
+    
+    // Take the question out of its bucket by moving the bucket's last entry into its slot
+    int d = get_question(game, index)->difficulty;
+    int slot = game->bucket_slot[index];
+    if (slot != -1) {
+        int moved = game->difficulty_index[d][--game->difficulty_count[d]];
+        game->difficulty_index[d][slot] = moved;
+        game->bucket_slot[moved] = slot;
+    }
+    
+    // Fill the hole with the last question so no other index changes
+    int last = game->total_questions - 1;
+    if (index != last) {
+        game->questions[index] = *get_question(game, last);
+        if (index < game->mapped_count) {
+            game->overlaid[index] = true;
+        }
+        game->bucket_slot[index] = game->bucket_slot[last];
+        if (game->bucket_slot[index] != -1) {
+            game->difficulty_index[game->questions[index].difficulty][game->bucket_slot[index]] = index;
+        }
+    }
+    game->total_questions--;
+    if (game->mapped_count > game->total_questions) {
+        game->mapped_count = game->total_questions;
+    }
+    return true;
+}
+
+int count_questions_by_difficulty(GameState* game, int difficulty) {
+    return game->difficulty_count[difficulty];
+}
+
+int question_bank_sample(const GameState* game, int difficulty, int* out, int max_count) {
+    // Partial Fisher-Yates that leaves the bucket untouched, so a mapped bucket can be
+    // sampled too: positions a swap changed are remembered in a small table instead
+    const int* bucket = question_bank_bucket(game, difficulty);
+    int count = game->difficulty_count[difficulty];
+    if (max_count > count) {
+        max_count = count;
+    }
+    if (max_count > QUESTIONS_PER_LEVEL) {
+        max_count = QUESTIONS_PER_LEVEL;
+    }
+    
+    int moved_position[QUESTIONS_PER_LEVEL];
+    int moved_value[QUESTIONS_PER_LEVEL];
+    int moved_count = 0;
+    for (int i = 0; i < max_count; i++) {
+        int j = i + rand() % (count - i);
+        
+        int value_i = bucket[i];
+        int value_j = bucket[j];
+        int j_entry = -1;
+        for (int m = 0; m < moved_count; m++) {
+            if (moved_position[m] == i) {
+                value_i = moved_value[m];
+            }
+            if (moved_position[m] == j) {
+                value_j = moved_value[m];
+                j_entry = m;
+            }
+        }
+        out[i] = value_j;
+        
+        // Position i is never drawn from again, only j needs to remember the swap
+        if (j_entry == -1) {
+            j_entry = moved_count++;
+            moved_position[j_entry] = j;
+        }
+        moved_value[j_entry] = value_i;
+    }
+    return max_count;
+}
+
+void master_login(SDL_Renderer* renderer, TTF_Font* font, GameState* game) {
+    SDL_Color WHITE = {255, 255, 255, 255};
+    SDL_Color BLUE = {0, 0, 128, 255};
+    SDL_Color LIGHT_BLUE = {100, 149, 237, 255};
+    SDL_Color RED = {255, 0, 0, 255};
+    
+    bool quit = false;
     SDL_Event event;
-    while (!done) {
-        while (SDL_PollEvent(&event)) {
+    
+    // Password protection
+    char password[MAX_NAME_LENGTH] = "admin123"; // Default password
+    char input[MAX_NAME_LENGTH] = {0};
+    
+    // Get password input
+    get_text_input(renderer, font, input, MAX_NAME_LENGTH, "Enter Master Password:");
+    
+    // Check password
+    if (strcmp(input, password) != 0) {
+        show_toast("Incorrect Password!", RED, 1500);
+        return;
+    }
+    
+    WidgetList menu = {0};
+    add_label(&menu, "MASTER MODE", SCREEN_WIDTH/2 - 100, 100, WHITE);
+    int add_questions_button = add_button(&menu, "Add Questions", SCREEN_WIDTH/2 - 100, 200, 200, 50, LIGHT_BLUE, WHITE);
+    int import_button = add_button(&menu, "Import Questions", SCREEN_WIDTH/2 - 100, 300, 200, 50, LIGHT_BLUE, WHITE);
+    int view_button = add_button(&menu, "View Questions", SCREEN_WIDTH/2 - 100, 400, 200, 50, LIGHT_BLUE, WHITE);
+    int history_button = add_button(&menu, "View Player History", SCREEN_WIDTH/2 - 100, 500, 200, 50, LIGHT_BLUE, WHITE);
+    int back_button = add_button(&menu, "Back to Menu", SCREEN_WIDTH/2 - 100, 600, 200, 50, LIGHT_BLUE, WHITE);
+    
+    bool redraw = true;
+    while (!quit) {
+        redraw |= prune_toasts();
+        if (redraw) {
+            SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
+            SDL_RenderClear(renderer);
+            render_widgets(renderer, font, &menu);
+            render_toasts(renderer, font);
+            SDL_RenderPresent(renderer);
+            redraw = false;
+        }
+        
+        // Sleep until input arrives instead of redrawing an idle screen
+        if (!SDL_WaitEventTimeout(&event, toast_wait_timeout(IDLE_WAIT_MS))) {
+            continue;
+        }
+        do {
+            if (event_invalidates_screen(&event)) {
+                redraw = true;
+            }
+            
             if (event.type == SDL_QUIT) {
-                done = true;
+                quit = true;
+                break;
             }
             
             if (event.type == SDL_MOUSEBUTTONDOWN) {
                 int mouse_x, mouse_y;
                 SDL_GetMouseState(&mouse_x, &mouse_y);
                 
-                if (is_button_clicked(mouse_x, mouse_y, SCREEN_WIDTH/2 - 100, 350, 200, 50)) {
-                    done = true;
+                int clicked = hit_test_widgets(&menu, mouse_x, mouse_y);
+                if (clicked == add_questions_button) {
+                    add_questions(renderer, font, game);
+                } else if (clicked == import_button) {
+                    import_questions(renderer, font, game);
+                } else if (clicked == view_button) {
+                    view_questions(renderer, font, game);
+                } else if (clicked == history_button) {
+                    show_player_history(renderer, font, game);
+                } else if (clicked == back_button) {
+                    quit = true;
                 }
             }
+        } while (SDL_PollEvent(&event));
+    }
+}
+
+void student_login(SDL_Renderer* renderer, TTF_Font* font, GameState* game) {
+    SDL_Color WHITE = {255, 255, 255, 255};
+    SDL_Color BLUE = {0, 0, 128, 255};
+    SDL_Color LIGHT_BLUE = {100, 149, 237, 255};
+    SDL_Color RED = {255, 0, 0, 255};
+    
+    // Get student name
+    get_text_input(renderer, font, game->current_player, MAX_NAME_LENGTH, "Enter your name:");
+    
+    bool quit = false;
+    SDL_Event event;
+    
+    char welcome[100];
+    sprintf(welcome, "Welcome, %s!", game->current_player);
+    
+    WidgetList menu = {0};
+    add_label(&menu, welcome, SCREEN_WIDTH/2 - 100, 100, WHITE);
+    
+    // Difficulty Selection Buttons, each with a note shown when it has no questions
+    const char* quiz_labels[3] = {"Easy Quiz", "Medium Quiz", "Hard Quiz"};
+    int quiz_buttons[3];
+    int empty_notes[3];
+    for (int d = DIFFICULTY_EASY; d <= DIFFICULTY_HARD; d++) {
+        quiz_buttons[d] = add_button(&menu, quiz_labels[d], SCREEN_WIDTH/2 - 100, 200 + d * 100, 200, 50, LIGHT_BLUE, WHITE);
+        empty_notes[d] = add_label(&menu, "No questions available", SCREEN_WIDTH/2 + 120, 215 + d * 100, WHITE);
+    }
+    
+    int history_button = add_button(&menu, "View History", SCREEN_WIDTH/2 - 100, 500, 200, 50, LIGHT_BLUE, WHITE);
+    int back_button = add_button(&menu, "Back to Menu", SCREEN_WIDTH/2 - 100, 600, 200, 50, LIGHT_BLUE, WHITE);
+    
+    bool redraw = true;
+    while (!quit) {
+        redraw |= prune_toasts();
+        if (redraw) {
+            // Difficulties without questions are shown in red
+            for (int d = DIFFICULTY_EASY; d <= DIFFICULTY_HARD; d++) {
+                bool available = count_questions_by_difficulty(game, d) > 0;
+                menu.items[quiz_buttons[d]].bg_color = available ? LIGHT_BLUE : RED;
+                menu.items[empty_notes[d]].visible = !available;
+            }
+            
+            SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
+            SDL_RenderClear(renderer);
+            render_widgets(renderer, font, &menu);
+            render_toasts(renderer, font);
+            SDL_RenderPresent(renderer);
+            redraw = false;
+        }
+        
+        // Sleep until input arrives instead of redrawing an idle screen
+        if (!SDL_WaitEventTimeout(&event, toast_wait_timeout(IDLE_WAIT_MS))) {
+            continue;
+        }
+        do {
+            if (event_invalidates_screen(&event)) {
+                redraw = true;
+            }
+            
+            if (event.type == SDL_QUIT) {
+                quit = true;
+                break;
+            }
+            
+            if (event.type == SDL_MOUSEBUTTONDOWN) {
+                int mouse_x, mouse_y;
+                SDL_GetMouseState(&mouse_x, &mouse_y);
+                
+                int clicked = hit_test_widgets(&menu, mouse_x, mouse_y);
+                
+                // Quiz buttons
+                for (int d = DIFFICULTY_EASY; d <= DIFFICULTY_HARD; d++) {
+                    if (clicked == quiz_buttons[d] && count_questions_by_difficulty(game, d) > 0) {
+                        start_quiz(renderer, font, game, d);
+                        show_results(renderer, font, game, d);
+                    }
+                }
+                
+                if (clicked == history_button) {
+                    show_player_history(renderer, font, game);
+                } else if (clicked == back_button) {
+                    quit = true;
+                }
+            }
+        } while (SDL_PollEvent(&event));
+    }
+}
+
+void timer_wheel_init(TimerWheel* wheel, Uint64 now_ms) {
+    memset(wheel, 0, sizeof(TimerWheel));
+    wheel->now = now_ms / TIMER_WHEEL_TICK_MS;
+    for (int i = 0; i <= TIMER_WHEEL_DUE; i++) {
+        wheel->heads[i] = -1;
+    }
+}
+
+bool timer_wheel_reserve(TimerWheel* wheel, int id) {
+    // Make room for timers 0..id
+    if (id < wheel->capacity) {
+        return true;
+    }
+    
+    int new_capacity = wheel->capacity ? wheel->capacity : 16;
+    while (new_capacity <= id) {
+        new_capacity *= 2;
+    }
+    Timer* timers = realloc(wheel->timers, new_capacity * sizeof(Timer));
+    if (!timers) {
+        printf("Failed to grow timer wheel to %d timers!\n", new_capacity);
+        return false;
+    }
+    for (int i = wheel->capacity; i < new_capacity; i++) {
+        timers[i].list = -1;
+    }
+    wheel->timers = timers;
+    wheel->capacity = new_capacity;
+    return true;
+}
+
+void timer_wheel_arm(TimerWheel* wheel, int id, Uint64 deadline_ms) {
+    // (Re)start timer id; it fires on the first tick at or after deadline_ms.
+    // Ids outside the reserved range are ignored.
+    if (id < 0 || id >= wheel->capacity) {
+        return;
+    }
+    timer_wheel_disarm(wheel, id);
+    wheel->timers[id].deadline = (deadline_ms + TIMER_WHEEL_TICK_MS - 1) / TIMER_WHEEL_TICK_MS;
+    timer_wheel_place(wheel, id);
+}
+
+void timer_wheel_disarm(TimerWheel* wheel, int id) {
+    if (id >= 0 && id < wheel->capacity && wheel->timers[id].list >= 0) {
+        timer_wheel_unlink(wheel, id);
+    }
+}
+
+void timer_wheel_place(TimerWheel* wheel, int id) {
+    // A timer goes on the finest level whose slots still reach its deadline.
+    // Its slot comes round within one turn of that level, when it moves down
+    Uint64 deadline = wheel->timers[id].deadline;
+    if (deadline <= wheel->now) {
+        timer_wheel_link(wheel, id, TIMER_WHEEL_DUE);
+        return;
+    }
+    
+    Uint64 delta = deadline - wheel->now;
+    int level = 0;
+    while (level < TIMER_WHEEL_LEVELS - 1 && delta >= (Uint64)1 << (TIMER_WHEEL_BITS * (level + 1))) {
+        level++;
+    }
+    
+    // Too far off for the top level: park it in the last slot it reaches and place it again from there
+    Uint64 span = (Uint64)1 << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS);
+    if (delta >= span) {
+        deadline = wheel->now + span - 1;
+    }
+    int slot = (int)(deadline >> (TIMER_WHEEL_BITS * level)) & (TIMER_WHEEL_SLOTS - 1);
+    timer_wheel_link(wheel, id, level * TIMER_WHEEL_SLOTS + slot);
+}
+
+void timer_wheel_link(TimerWheel* wheel, int id, int list) {
+    Timer* timer = &wheel->timers[id];
+    timer->list = list;
+    timer->prev = -1;
+    timer->next = wheel->heads[list];
+    if (timer->next >= 0) {
+        wheel->timers[timer->next].prev = id;
+    }
+    wheel->heads[list] = id;
+    if (list != TIMER_WHEEL_DUE) {
+        wheel->scheduled++;
+    }
+}
+
+void timer_wheel_unlink(TimerWheel* wheel, int id) {
+    Timer* timer = &wheel->timers[id];
+    if (timer->prev >= 0) {
+        wheel->timers[timer->prev].next = timer->next;
+    } else {
+        wheel->heads[timer->list] = timer->next;
+    }
+    if (timer->next >= 0) {
+        wheel->timers[timer->next].prev = timer->prev;
+    }
+    if (timer->list != TIMER_WHEEL_DUE) {
+        wheel->scheduled--;
+    }
+    timer->list = -1;
+}
+
+void timer_wheel_cascade(TimerWheel* wheel, int list) {
+    // Empty a slot, placing each timer again relative to the current tick
+    int id = wheel->heads[list];
+    while (id >= 0) {
+        int next = wheel->timers[id].next;
+        timer_wheel_unlink(wheel, id);
+        timer_wheel_place(wheel, id);
+        id = next;
+    }
+}
+
+int timer_wheel_expire(TimerWheel* wheel, Uint64 now_ms) {
+    // Process the ticks up to now_ms, then hand out one fired timer per call; -1 when none are left
+    Uint64 target = now_ms / TIMER_WHEEL_TICK_MS;
+    while (wheel->now < target) {
+        if (wheel->scheduled == 0) {
+            wheel->now = target;
+            break;
+        }
+        
+        Uint64 tick = ++wheel->now;
+        int mask = TIMER_WHEEL_SLOTS - 1;
+        if ((tick & mask) == 0) {
+            // Coarser slots move down as the finer level wraps, top level first
+            for (int level = TIMER_WHEEL_LEVELS - 1; level > 0; level--) {
+                Uint64 wrap = ((Uint64)1 << (TIMER_WHEEL_BITS * level)) - 1;
+                if ((tick & wrap) == 0) {
+                    int slot = (int)(tick >> (TIMER_WHEEL_BITS * level)) & mask;
+                    timer_wheel_cascade(wheel, level * TIMER_WHEEL_SLOTS + slot);
+                }
+            }
+        }
+        timer_wheel_cascade(wheel, (int)(tick & mask));
+    }
+    
+    int id = wheel->heads[TIMER_WHEEL_DUE];
+    if (id >= 0) {
+        timer_wheel_unlink(wheel, id);
+    }
+    return id;
+}
+
+int timer_wheel_timeout(const TimerWheel* wheel, Uint64 now_ms) {
+    // Milliseconds until the wheel next has a timer to fire or a slot to move down, -1 when empty.
+    // Level 0 is searched tick by tick, beyond it only the ticks where level 1 moves down
+    if (wheel->heads[TIMER_WHEEL_DUE] >= 0) {
+        return 0;
+    }
+    if (wheel->scheduled == 0) {
+        return -1;
+    }
+    
+    int mask = TIMER_WHEEL_SLOTS - 1;
+    Uint64 tick = wheel->now + 1;
+    for (;;) {
+        if (tick - wheel->now < TIMER_WHEEL_SLOTS && wheel->heads[tick & mask] >= 0) {
+            break;
+        }
+        if ((tick & mask) == 0) {
+            int slot = (int)(tick >> TIMER_WHEEL_BITS) & mask;
+            if (slot == 0 || wheel->heads[TIMER_WHEEL_SLOTS + slot] >= 0) {
+                break;
+            }
+        }
+        tick = tick - wheel->now < TIMER_WHEEL_SLOTS - 1 ? tick + 1 : ((tick >> TIMER_WHEEL_BITS) + 1) << TIMER_WHEEL_BITS;
+    }
+    
+    Uint64 wake_ms = tick * TIMER_WHEEL_TICK_MS;
+    if (wake_ms <= now_ms) {
+        return 0;
+    }
+    return wake_ms - now_ms < INT_MAX ? (int)(wake_ms - now_ms) : INT_MAX;
+}
+
+void timer_wheel_free(TimerWheel* wheel) {
+    free(wheel->timers);
+    memset(wheel, 0, sizeof(TimerWheel));
+}
+
+void quiz_engine_start(QuizSession* session, const GameState* game, int difficulty) {
+    // Draw up to QUESTIONS_PER_LEVEL random questions of this difficulty
+    memset(session, 0, sizeof(QuizSession));
+    session->difficulty = difficulty;
+    session->time_limit_ms = question_time_limits[difficulty] * 1000;
+    session->question_count = question_bank_sample(game, difficulty, session->order, QUESTIONS_PER_LEVEL);
+    session->state = session->question_count > 0 ? QUIZ_STATE_QUESTION : QUIZ_STATE_FINISHED;
+}
+
+const Question* quiz_engine_question(const QuizSession* session, const GameState* game) {
+    // The question being asked, or NULL once the quiz is over
+    if (session->state != QUIZ_STATE_QUESTION) {
+        return NULL;
+    }
+    return get_question(game, session->order[session->current]);
+}
+
+int quiz_engine_time_remaining(const QuizSession* session, Uint32 unticked_ms) {
+    // Whole seconds left on the current question, as the timer shows them,
+    // counting time that has passed but not been ticked yet
+    int remaining = (int)(session->time_limit_ms / 1000) - (int)((session->elapsed_ms + unticked_ms) / 1000);
+    return remaining > 0 ? remaining : 0;
+}
+
+int quiz_engine_submit(QuizSession* session, const GameState* game, int option, Uint32 elapsed_ms) {
+    // elapsed_ms is the time since the last tick, an answer that arrives after the limit times out
+    if (session->state != QUIZ_STATE_QUESTION || option < 0 || option >= MAX_OPTIONS) {
+        return QUIZ_RESULT_NONE;
+    }
+    int timeout = quiz_engine_tick(session, elapsed_ms);
+    if (timeout != QUIZ_RESULT_NONE) {
+        return timeout;
+    }
+    session->answer_ms += session->elapsed_ms;
+    
+    // Check answer
+    int result;
+    if (option == quiz_engine_question(session, game)->correct_option) {
+        session->score += 5; // Correct answer: +5 points
+        session->correct_mask |= 1 << session->current;
+        result = QUIZ_RESULT_CORRECT;
+    } else {
+        session->score -= 1; // Incorrect answer: -1 point
+        result = QUIZ_RESULT_WRONG;
+    }
+    quiz_engine_advance(session);
+    return result;
+}
+
+int quiz_engine_tick(QuizSession* session, Uint32 elapsed_ms) {
+    // A question that runs out of time scores nothing and the quiz moves on
+    if (session->state != QUIZ_STATE_QUESTION) {
+        return QUIZ_RESULT_NONE;
+    }
+    session->elapsed_ms += elapsed_ms;
+    if (session->elapsed_ms < session->time_limit_ms) {
+        return QUIZ_RESULT_NONE;
+    }
+    session->answer_ms += session->time_limit_ms;
+    quiz_engine_advance(session);
+    return QUIZ_RESULT_TIMEOUT;
+}
+
+void quiz_engine_advance(QuizSession* session) {
+    session->elapsed_ms = 0;
+    if (++session->current >= session->question_count) {
+        session->state = QUIZ_STATE_FINISHED;
+    }
+}
+
+int quiz_engine_finish(QuizSession* session, GameState* game, const char* player, Sint64 timestamp) {
+    // Add a finished quiz to the player's history, once; returns their ID, or -1
+    if (session->state != QUIZ_STATE_FINISHED) {
+        return -1;
+    }
+    session->state = QUIZ_STATE_RECORDED;
+    
+    int id = add_player_score(game, player, session->difficulty, session->score);
+    if (id >= 0) {
+        Attempt attempt = {timestamp, id, session->difficulty, session->score, session->correct_mask,
+                           session->question_count, session->answer_ms};
+        attempt_history_append(game, &attempt);
+    }
+    return id;
+}
+
+void start_quiz(SDL_Renderer* renderer, TTF_Font* font, GameState* game, int difficulty) {
+    SDL_Color WHITE = {255, 255, 255, 255};
+    SDL_Color BLUE = {0, 0, 128, 255};
+    SDL_Color LIGHT_BLUE = {100, 149, 237, 255};
+    SDL_Color GREEN = {0, 255, 0, 255};
+    SDL_Color RED = {255, 0, 0, 255};
+    
+    // The engine runs the quiz, this screen draws it and feeds it clicks and time
+    QuizSession session;
+    quiz_engine_start(&session, game, difficulty);
+    
+    // The question deadline is a timer, so the loop sleeps until input, the next second or time's up
+    TimerWheel timers;
+    timer_wheel_init(&timers, SDL_GetTicks64());
+    if (!timer_wheel_reserve(&timers, 0)) {
+        return;
+    }
+    
+    while (session.state == QUIZ_STATE_QUESTION) {
+        const Question* current_question = quiz_engine_question(&session, game);
+        int selected_option = -1;
+        
+        // Lay out the question screen once
+        char question_num[50];
+        sprintf(question_num, "Question %d/%d", session.current + 1, session.question_count);
+        char option_texts[MAX_OPTIONS][150];
+        
+        WidgetList screen = {0};
+        add_label(&screen, question_num, 50, 50, WHITE);
+        add_label(&screen, question_text(game, current_question), 50, 100, WHITE);
+        int first_option = screen.count;
+        for (int i = 0; i < MAX_OPTIONS; i++) {
+            sprintf(option_texts[i], "%d. %s", i + 1, option_text(game, current_question, i));
+            add_button(&screen, option_texts[i], 100, 200 + i * 80, 600, 50, LIGHT_BLUE, WHITE);
+        }
+        
+        // Submit button appears once an option is selected
+        int submit_button = add_button(&screen, "Submit Answer", SCREEN_WIDTH/2 - 100, 550, 200, 50, GREEN, WHITE);
+        screen.items[submit_button].visible = false;
+        
+        // Start timer for this question
+        Uint64 question_start = SDL_GetTicks64();
+        timer_wheel_arm(&timers, 0, question_start + session.time_limit_ms);
+        
+        bool redraw = true;
+        int shown_time = -1;
+        int result = QUIZ_RESULT_NONE;
+        while (result == QUIZ_RESULT_NONE) {
+            // The engine's clock only moves when its deadline fires or an answer comes in
+            Uint64 now = SDL_GetTicks64();
+            if (timer_wheel_expire(&timers, now) >= 0) {
+                result = quiz_engine_tick(&session, (Uint32)(now - question_start));
+                break;
+            }
+            Uint32 elapsed = (Uint32)(now - question_start);
+            int time_remaining = quiz_engine_time_remaining(&session, elapsed);
+            
+            // The timer only invalidates the frame once per second
+            if (time_remaining != shown_time) {
+                redraw = true;
+            }
+            
+            redraw |= prune_toasts();
+            if (redraw) {
+                SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
+                SDL_RenderClear(renderer);
+                render_widgets(renderer, font, &screen);
+                
+                // Display timer
+                render_timer(renderer, font, time_remaining, SCREEN_WIDTH - 150, 50);
+                
+                render_toasts(renderer, font);
+                SDL_RenderPresent(renderer);
+                shown_time = time_remaining;
+                redraw = false;
+            }
+            
+            SDL_Event event;
+            
+            // Sleep until input arrives, the timer reaches its next second or the deadline passes
+            int timeout = 1000 - elapsed % 1000;
+            int deadline = timer_wheel_timeout(&timers, now);
+            if (deadline >= 0 && deadline < timeout) {
+                timeout = deadline;
+            }
+            if (!SDL_WaitEventTimeout(&event, toast_wait_timeout(timeout))) {
+                continue;
+            }
+            do {
+                if (event_invalidates_screen(&event)) {
+                    redraw = true;
+                }
+                
+                if (event.type == SDL_QUIT) {
+                    timer_wheel_free(&timers);
+                    return;
+                }
+                
+                if (event.type == SDL_MOUSEBUTTONDOWN) {
+                    int mouse_x, mouse_y;
+                    SDL_GetMouseState(&mouse_x, &mouse_y);
+                    
+                    int clicked = hit_test_widgets(&screen, mouse_x, mouse_y);
+                    
+                    // Option buttons: highlight the selected one
+                    if (clicked >= first_option && clicked < first_option + MAX_OPTIONS) {
+                        if (selected_option != -1) {
+                            screen.items[first_option + selected_option].bg_color = LIGHT_BLUE;
+                        }
+                        selected_option = clicked - first_option;
+                        screen.items[clicked].bg_color = GREEN;
+                        screen.items[submit_button].visible = true;
+                    }
+                    
+                    // Submit button: the engine treats an answer past the limit as a timeout
+                    if (clicked == submit_button && result == QUIZ_RESULT_NONE) {
+                        result = quiz_engine_submit(&session, game, selected_option, (Uint32)(SDL_GetTicks64() - question_start));
+                    }
+                }
+            } while (result == QUIZ_RESULT_NONE && SDL_PollEvent(&event));
+        }
+        timer_wheel_disarm(&timers, 0);
+        
+        // Time's up: tell the player over the next question instead of pausing
+        if (result == QUIZ_RESULT_TIMEOUT) {
+            show_toast("Time's up!", RED, 2000);
+            
+            // Show correct answer
+            char correct_answer[100];
+            sprintf(correct_answer, "Correct answer: %d", current_question->correct_option + 1);
+            show_toast(correct_answer, GREEN, 2000);
+        }
+    }
+    
+    timer_wheel_free(&timers);
+    
+    // Store score for this difficulty
+    game->current_score[difficulty] = session.score;
+    
+    // Add to player history
+    quiz_engine_finish(&session, game, game->current_player, time(NULL));
+}
+
+void show_results(SDL_Renderer* renderer, TTF_Font* font, GameState* game, int difficulty) {
+    SDL_Color WHITE = {255, 255, 255, 255};
+    SDL_Color BLUE = {0, 0, 128, 255};
+    SDL_Color GREEN = {0, 255, 0, 255};
+    SDL_Color RED = {255, 0, 0, 255};
+    
+    const char* difficulty_str;
+    switch (difficulty) {
+        case DIFFICULTY_EASY: difficulty_str = "Easy"; break;
+        case DIFFICULTY_MEDIUM: difficulty_str = "Medium"; break;
+        case DIFFICULTY_HARD: difficulty_str = "Hard"; break;
+        default: difficulty_str = "Unknown";
+    }
+    
+    WidgetList screen = {0};
+    
+    // Title
+    char title[100];
+    sprintf(title, "%s Quiz Results", difficulty_str);
+    add_label(&screen, title, SCREEN_WIDTH/2 - 100, 100, WHITE);
+    
+    // Player Name
+    char name_text[100];
+    sprintf(name_text, "Player: %s", game->current_player);
+    add_label(&screen, name_text, SCREEN_WIDTH/2 - 100, 150, WHITE);
+    
+    // Score
+    char score_text[50];
+    sprintf(score_text, "Score: %d", game->current_score[difficulty]);
+    add_label(&screen, score_text, SCREEN_WIDTH/2 - 100, 200,
+              game->current_score[difficulty] >= 0 ? GREEN : RED);
+    
+    // Percentage
+    int available = count_questions_by_difficulty(game, difficulty);
+    int questions_asked = available < QUESTIONS_PER_LEVEL ? available : QUESTIONS_PER_LEVEL;
+    float percentage = (float)game->current_score[difficulty] / (questions_asked * 5) * 100;
+    char percentage_text[50];
+    sprintf(percentage_text, "Percentage: %.1f%%", percentage);
+    add_label(&screen, percentage_text, SCREEN_WIDTH/2 - 100, 250, WHITE);
+    
+    // Standing on this difficulty's leaderboard
+    int id = find_player(game, game->current_player);
+    const Leaderboard* ranking = &game->leaderboards[difficulty];
+    int rank = id >= 0 ? leaderboard_rank(ranking, id) : 0;
+    char rank_text[64] = {0};
+    if (rank > 0) {
+        sprintf(rank_text, "Best rank: #%d of %d", rank, ranking->total);
+    }
+    add_label(&screen, rank_text, SCREEN_WIDTH/2 - 100, 300, WHITE);
+    
+    // Back Button
+    int continue_button = add_button(&screen, "Continue", SCREEN_WIDTH/2 - 100, 350, 200, 50, GREEN, WHITE);
+    
+    // Toasts raised during the quiz, such as a timeout, are redrawn until they expire
+    bool redraw = true;
+    while (true) {
+        redraw |= prune_toasts();
+        if (redraw) {
+            SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
+            SDL_RenderClear(renderer);
+            render_widgets(renderer, font, &screen);
+            render_toasts(renderer, font);
+            SDL_RenderPresent(renderer);
+            redraw = false;
+        }
+        
+        SDL_Event event;
+        
+        // Sleep until input arrives instead of redrawing an idle screen
+        if (!SDL_WaitEventTimeout(&event, toast_wait_timeout(IDLE_WAIT_MS))) {
+            continue;
+        }
+        do {
+            if (event_invalidates_screen(&event)) {
+                redraw = true;
+            }
+            
+            if (event.type == SDL_QUIT) {
+                return;
+            }
+            
+            // Wait for back button
+            if (event.type == SDL_MOUSEBUTTONDOWN) {
+                int mouse_x, mouse_y;
+                SDL_GetMouseState(&mouse_x, &mouse_y);
+                if (hit_test_widgets(&screen, mouse_x, mouse_y) == continue_button) {
+                    return;
+                }
+            }
+        } while (SDL_PollEvent(&event));
+    }
+}
+
+void show_player_history(SDL_Renderer* renderer, TTF_Font* font, GameState* game) {
+    SDL_Color WHITE = {255, 255, 255, 255};
+    SDL_Color BLUE = {0, 0, 128, 255};
+    SDL_Color GREEN = {0, 255, 0, 255};
+    SDL_Color RED = {255, 0, 0, 255};
+    SDL_Color LIGHT_BLUE = {100, 149, 237, 255};
+    
+    bool quit = false;
+    int start_index = 0;
+    int players_per_page = 5;
+    int page[5];
+    AttemptStats page_stats[5][ATTEMPT_STATS_OVERALL + 1];
+    int listed = 0;
+    bool page_changed = true;
+    
+    // Players are listed in rank order on the chosen leaderboard
+    static const char* board_names[LEADERBOARD_COUNT] = {
+        "Ranked by: Easy", "Ranked by: Medium", "Ranked by: Hard", "Ranked by: Overall"
+    };
+    int board = LEADERBOARD_OVERALL;
+    
+    WidgetList screen = {0};
+    add_label(&screen, "Player History", SCREEN_WIDTH/2 - 100, 50, WHITE);
+    int rank_button = add_button(&screen, board_names[board], SCREEN_WIDTH - 250, 40, 220, 40, LIGHT_BLUE, WHITE);
+    
+    // Column headers
+    add_label(&screen, "Player", 50, 100, WHITE);
+    add_label(&screen, "Easy", 230, 100, WHITE);
+    add_label(&screen, "Medium", 360, 100, WHITE);
+    add_label(&screen, "Hard", 490, 100, WHITE);
+    add_label(&screen, "Correct", 620, 100, WHITE);
+    add_label(&screen, "Best/mean, green while improving", 50, 400, WHITE);
+    
+    // Navigation buttons
+    int previous_button = add_button(&screen, "Previous", 50, 450, 150, 50, LIGHT_BLUE, WHITE);
+    int next_button = add_button(&screen, "Next", SCREEN_WIDTH - 200, 450, 150, 50, LIGHT_BLUE, WHITE);
+    int back_button = add_button(&screen, "Back", SCREEN_WIDTH/2 - 75, 520, 150, 50, GREEN, WHITE);
+    
+    bool redraw = true;
+    while (!quit) {
+        redraw |= prune_toasts();
+        if (page_changed) {
+            // Summarise the listed players' attempts once per page, not on every redraw
+            listed = leaderboard_list(&game->leaderboards[board], start_index, page, players_per_page);
+            for (int i = 0; i < listed; i++) {
+                attempt_stats_all(&game->attempts, page[i], page_stats[i]);
+            }
+            page_changed = false;
+        }
+        if (redraw) {
+            const Leaderboard* ranking = &game->leaderboards[board];
+            screen.items[previous_button].visible = start_index > 0;
+            screen.items[next_button].visible = start_index + players_per_page < ranking->total;
+            
+            SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
+            SDL_RenderClear(renderer);
+            render_widgets(renderer, font, &screen);
+            
+            // Display players, summarising every attempt they have made
+            for (int i = 0; i < listed; i++) {
+                int id = page[i];
+                const Player* p = &game->players[id];
+                int y = 150 + i * 50;
+                
+                // Rank and player name
+                char name[MAX_NAME_LENGTH + 16];
+                sprintf(name, "#%d %s", leaderboard_rank(ranking, id), p->name);
+                render_text(renderer, font, name, 50, y, WHITE);
+                
+                // Best and mean score per difficulty
+                for (int d = DIFFICULTY_EASY; d <= DIFFICULTY_HARD; d++) {
+                    const AttemptStats* stats = &page_stats[i][d];
+                    char cell[32];
+                    SDL_Color color = WHITE;
+                    if (stats->attempts > 0) {
+                        sprintf(cell, "%d/%.0f", stats->best, stats->mean);
+                        color = stats->trend >= 0 ? GREEN : RED;
+                    } else if (p->scores[d] >= 0) {
+                        // Scored before attempts were recorded, only the last score is known
+                        sprintf(cell, "%d", p->scores[d]);
+                    } else {
+                        sprintf(cell, "-");
+                    }
+                    render_text(renderer, font, cell, 230 + d * 130, y, color);
+                }
+                
+                // Share of answers correct and time per question across all attempts
+                const AttemptStats* overall = &page_stats[i][ATTEMPT_STATS_OVERALL];
+                if (overall->attempts > 0) {
+                    char accuracy[32];
+                    sprintf(accuracy, "%.0f%% %.0fs", overall->accuracy * 100, overall->mean_answer_ms / 1000);
+                    render_text(renderer, font, accuracy, 620, y, WHITE);
+                }
+            }
+            
+            render_toasts(renderer, font);
+            SDL_RenderPresent(renderer);
+            redraw = false;
+        }
+        
+        SDL_Event event;
+        
+        // Sleep until input arrives instead of redrawing an idle screen
+        if (!SDL_WaitEventTimeout(&event, toast_wait_timeout(IDLE_WAIT_MS))) {
+            continue;
+        }
+        do {
+            if (event_invalidates_screen(&event)) {
+                redraw = true;
+            }
+            
+            if (event.type == SDL_QUIT) {
+                quit = true;
+            }
+            
+            if (event.type == SDL_MOUSEBUTTONDOWN) {
+                int mouse_x, mouse_y;
+                SDL_GetMouseState(&mouse_x, &mouse_y);
+                
+                int clicked = hit_test_widgets(&screen, mouse_x, mouse_y);
+                if (clicked == rank_button) {
+                    board = (board + 1) % LEADERBOARD_COUNT;
+                    screen.items[rank_button].text = board_names[board];
+                    start_index = 0;
+                    page_changed = true;
+                } else if (clicked == previous_button && start_index > 0) {
+                    start_index -= players_per_page;
+                    if (start_index < 0) start_index = 0;
+                    page_changed = true;
+                } else if (clicked == next_button && start_index + players_per_page < game->leaderboards[board].total) {
+                    start_index += players_per_page;
+                    page_changed = true;
+                } else if (clicked == back_button) {
+                    quit = true;
+                }
+            }
+        } while (SDL_PollEvent(&event));
+    }
+}
+
+int add_player_score(GameState* game, const char* name, int difficulty, int score) {
+    // Find the player by name, adding them on their first quiz
+    int id = register_player(game, name);
+    if (id < 0) {
+        return -1;
+    }
+    game->players[id].scores[difficulty] = score;
+    leaderboard_submit(game, id, difficulty, score);
+    
+    // Record just this score, the player file is rewritten only when the log is compacted
+    score_log_append(game, id, difficulty, score);
+    return id;
+}
+
+bool player_registry_reserve(GameState* game, int capacity) {
+    if (capacity <= game->player_capacity) {
+        return true;
+    }
+    
+    int new_capacity = game->player_capacity ? game->player_capacity : INITIAL_PLAYER_CAPACITY;
+    while (new_capacity < capacity) {
+        new_capacity *= 2;
+    }
+    Player* players = realloc(game->players, new_capacity * sizeof(Player));
+    if (!players) {
+        printf("Failed to grow player registry to %d players!\n", new_capacity);
+        return false;
+    }
+    game->players = players;
+    game->player_capacity = new_capacity;
+    return true;
+}
+
+bool player_registry_rehash(GameState* game, int slot_count) {
+    int* slots = calloc(slot_count, sizeof(int));
+    if (!slots) {
+        printf("Failed to grow player table to %d slots!\n", slot_count);
+        return false;
+    }
+    
+    // Earlier IDs win if a file ever held the same name twice
+    Uint32 mask = slot_count - 1;
+    for (int id = 0; id < game->total_players; id++) {
+        Uint32 slot = string_pool_hash(game->players[id].name) & mask;
+        while (slots[slot] != 0 && strcmp(game->players[slots[slot] - 1].name, game->players[id].name) != 0) {
+            slot = (slot + 1) & mask;
+        }
+        if (slots[slot] == 0) {
+            slots[slot] = id + 1;
+        }
+    }
+    
+    free(game->player_slots);
+    game->player_slots = slots;
+    game->player_slot_count = slot_count;
+    return true;
+}
+
+int find_player(const GameState* game, const char* name) {
+    if (game->player_slot_count == 0) {
+        return -1;
+    }
+    
+    Uint32 mask = game->player_slot_count - 1;
+    Uint32 slot = string_pool_hash(name) & mask;
+    while (game->player_slots[slot] != 0) {
+        int id = game->player_slots[slot] - 1;
+        if (strcmp(game->players[id].name, name) == 0) {
+            return id;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return -1;
+}
+
+int register_player(GameState* game, const char* name) {
+    int id = find_player(game, name);
+    if (id >= 0) {
+        return id;
+    }
+    
+    // Keep the name table under 3/4 full so probe chains stay short
+    if ((game->total_players + 1) * 4 > game->player_slot_count * 3 &&
+        !player_registry_rehash(game, game->player_slot_count ? game->player_slot_count * 2 : PLAYER_TABLE_INITIAL_SLOTS)) {
+        return -1;
+    }
+    if (!player_registry_reserve(game, game->total_players + 1)) {
+        return -1;
+    }
+    
+    // New players get the next ID, with every difficulty not attempted yet
+    id = game->total_players++;
+    Player* player = &game->players[id];
+    memset(player, 0, sizeof(Player));
+    snprintf(player->name, MAX_NAME_LENGTH, "%s", name);
+    for (int i = 0; i < 3; i++) {
+        player->scores[i] = -1;
+    }
+    
+    Uint32 mask = game->player_slot_count - 1;
+    Uint32 slot = string_pool_hash(player->name) & mask;
+    while (game->player_slots[slot] != 0) {
+        slot = (slot + 1) & mask;
+    }
+    game->player_slots[slot] = id + 1;
+    return id;
+}
+
+void player_registry_free(GameState* game) {
+    free(game->players);
+    free(game->player_slots);
+    game->players = NULL;
+    game->player_slots = NULL;
+    game->total_players = 0;
+    game->player_capacity = 0;
+    game->player_slot_count = 0;
+}
+
+void add_questions(SDL_Renderer* renderer, TTF_Font* font, GameState* game) {
+    SDL_Color WHITE = {255, 255, 255, 255};
+    SDL_Color BLUE = {0, 0, 128, 255};
+    SDL_Color LIGHT_BLUE = {100, 149, 237, 255};
+    SDL_Color GREEN = {0, 255, 0, 255};
+    SDL_Color RED = {255, 0, 0, 255};
+    
+    Question new_question = {0};
+    
+    // Select Difficulty
+    WidgetList screen = {0};
+    add_label(&screen, "Select Difficulty", SCREEN_WIDTH/2 - 100, 100, WHITE);
+    int easy_button = add_button(&screen, "Easy", SCREEN_WIDTH/2 - 100, 200, 200, 50, LIGHT_BLUE, WHITE);
+    int medium_button = add_button(&screen, "Medium", SCREEN_WIDTH/2 - 100, 300, 200, 50, LIGHT_BLUE, WHITE);
+    int hard_button = add_button(&screen, "Hard", SCREEN_WIDTH/2 - 100, 400, 200, 50, LIGHT_BLUE, WHITE);
+    
+    bool difficulty_selected = false;
+    bool redraw = true;
+    while (!difficulty_selected) {
+        redraw |= prune_toasts();
+        if (redraw) {
+            SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
+            SDL_RenderClear(renderer);
+            render_widgets(renderer, font, &screen);
+            render_toasts(renderer, font);
+            SDL_RenderPresent(renderer);
+            redraw = false;
+        }
+        
+        SDL_Event event;
+        
+        // Sleep until input arrives instead of redrawing an idle screen
+        if (!SDL_WaitEventTimeout(&event, toast_wait_timeout(IDLE_WAIT_MS))) {
+            continue;
+        }
+        do {
+            if (event_invalidates_screen(&event)) {
+                redraw = true;
+            }
+            
+            if (event.type == SDL_QUIT) {
+                return;
+            }
+            
+            if (event.type == SDL_MOUSEBUTTONDOWN) {
+                int mouse_x, mouse_y;
+                SDL_GetMouseState(&mouse_x, &mouse_y);
+                
+                int clicked = hit_test_widgets(&screen, mouse_x, mouse_y);
+                if (clicked == easy_button) {
+                    new_question.difficulty = DIFFICULTY_EASY;
+                    difficulty_selected = true;
+                } else if (clicked == medium_button) {
+                    new_question.difficulty = DIFFICULTY_MEDIUM;
+                    difficulty_selected = true;
+                } else if (clicked == hard_button) {
+                    new_question.difficulty = DIFFICULTY_HARD;
+                    difficulty_selected = true;
+                }
+            }
+        } while (SDL_PollEvent(&event));
+    }
+    
+    // Enter Question
+    SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
+    SDL_RenderClear(renderer);
+    render_text(renderer, font, "Enter Question", SCREEN_WIDTH/2 - 100, 100, WHITE);
+    SDL_RenderPresent(renderer);
+    
+    char question_input[MAX_QUESTION_LENGTH];
+    get_text_input(renderer, font, question_input, MAX_QUESTION_LENGTH, "Enter the question:");
+    
+    // Interned text is shared, so a duplicate question has the same offset. The text is
+    // only interned once the question is complete, so a rejected one leaves the pool alone
+    Uint32 existing = string_pool_find(&game->strings, question_input);
+    if (existing != 0 || question_input[0] == '\0') {
+        for (int i = 0; i < game->total_questions; i++) {
+            if (get_question(game, i)->question == existing) {
+                show_toast("Question already exists!", RED, 1500);
+                return;
+            }
+        }
+    }
+    
+    // Enter Options
+    char option_inputs[MAX_OPTIONS][MAX_OPTION_LENGTH];
+    const char* options[MAX_OPTIONS];
+    for (int i = 0; i < MAX_OPTIONS; i++) {
+        SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
+        SDL_RenderClear(renderer);
+        
+        char option_prompt[100];
+        sprintf(option_prompt, "Enter Option %d", i + 1);
+        render_text(renderer, font, option_prompt, SCREEN_WIDTH/2 - 100, 100, WHITE);
+        SDL_RenderPresent(renderer);
+        
+        get_text_input(renderer, font, option_inputs[i], MAX_OPTION_LENGTH, option_prompt);
+        options[i] = option_inputs[i];
+    }
+    
+    // Select Correct Option
+    int correct_option = select_correct_option(renderer, font, options);
+    if (correct_option < 0) {
+        return;
+    }
+    new_question.correct_option = correct_option;
+    new_question.question = string_pool_intern(&game->strings, question_input);
+    for (int i = 0; i < MAX_OPTIONS; i++) {
+        new_question.options[i] = string_pool_intern(&game->strings, option_inputs[i]);
+    }
+    
+    // Add question to game
+    int index = question_bank_add(game, &new_question);
+    if (index < 0) {
+        show_toast("Could not add question!", RED, 1500);
+        return;
+    }
+    
+    // Save questions
+    journal_append(game, JOURNAL_ADD, index, &new_question);
+    
+    // Confirmation
+    show_toast("Question Added Successfully!", GREEN, 1500);
+}
+
+void import_questions(SDL_Renderer* renderer, TTF_Font* font, GameState* game) {
+    SDL_Color WHITE = {255, 255, 255, 255};
+    SDL_Color BLUE = {0, 0, 128, 255};
+    SDL_Color RED = {255, 0, 0, 255};
+    
+    char path[IMPORT_PATH_LENGTH];
+    get_text_input(renderer, font, path, IMPORT_PATH_LENGTH, "CSV or JSON lines file to import:");
+    if (path[0] == '\0') {
+        return;
+    }
+    ImportBatch* batch = import_batch_new(game, path);
+    if (!batch) {
+        show_toast("Could not start the import!", RED, 1500);
+        return;
+    }
+    
+    // The file is parsed on the thread pool; the merge and its summary come back through the event loop
+    pool_submit(import_run, import_done, batch);
+    
+    int shown = -1;
+    bool redraw = true;
+    while (!batch->finished) {
+        int progress = SDL_AtomicGet(&batch->progress);
+        redraw |= progress != shown;
+        redraw |= prune_toasts();
+        if (redraw) {
+            SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
+            SDL_RenderClear(renderer);
+            render_text(renderer, font, "Importing Questions...", SCREEN_WIDTH/2 - 100, 200, WHITE);
+            render_dynamic_text(renderer, font, path, SCREEN_WIDTH/2 - 100, 250, WHITE);
+            
+            char status[32];
+            snprintf(status, sizeof(status), "%d%% read", progress);
+            render_dynamic_text(renderer, font, status, SCREEN_WIDTH/2 - 100, 300, WHITE);
+            render_toasts(renderer, font);
+            SDL_RenderPresent(renderer);
+            shown = progress;
+            redraw = false;
+        }
+        
+        SDL_Event event;
+        
+        // Wake regularly to move the progress on while the file is read
+        if (!SDL_WaitEventTimeout(&event, toast_wait_timeout(IMPORT_PROGRESS_MS))) {
+            continue;
+        }
+        do {
+            if (event_invalidates_screen(&event)) {
+                redraw = true;
+            }
+            
+            // Closing the window leaves the batch to import_done, the menus below see the quit
+            if (event.type == SDL_QUIT) {
+                batch->abandoned = true;
+                SDL_PushEvent(&event);
+                return;
+            }
+        } while (!batch->finished && SDL_PollEvent(&event));
+    }
+    import_batch_free(batch);
+}
+
+int select_correct_option(SDL_Renderer* renderer, TTF_Font* font, const char* const options[MAX_OPTIONS]) {
+    SDL_Color WHITE = {255, 255, 255, 255};
+    SDL_Color BLUE = {0, 0, 128, 255};
+    SDL_Color LIGHT_BLUE = {100, 149, 237, 255};
+    
+    // Returns the chosen option, or -1 if the window was closed
+    char button_texts[MAX_OPTIONS][MAX_OPTION_LENGTH + 10];
+    
+    WidgetList screen = {0};
+    add_label(&screen, "Select Correct Option", SCREEN_WIDTH/2 - 100, 100, WHITE);
+    int first_option = screen.count;
+    for (int i = 0; i < MAX_OPTIONS; i++) {
+        sprintf(button_texts[i], "%d. %s", i + 1, options[i]);
+        add_button(&screen, button_texts[i], SCREEN_WIDTH/2 - 100, 200 + i * 80, 200, 50, LIGHT_BLUE, WHITE);
+    }
+    
+    bool redraw = true;
+    while (true) {
+        redraw |= prune_toasts();
+        if (redraw) {
+            SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
+            SDL_RenderClear(renderer);
+            render_widgets(renderer, font, &screen);
+            render_toasts(renderer, font);
+            SDL_RenderPresent(renderer);
+            redraw = false;
+        }
+        
+        SDL_Event event;
+        
+        // Sleep until input arrives instead of redrawing an idle screen
+        if (!SDL_WaitEventTimeout(&event, toast_wait_timeout(IDLE_WAIT_MS))) {
+            continue;
+        }
+        do {
+            if (event_invalidates_screen(&event)) {
+                redraw = true;
+            }
+            
+            if (event.type == SDL_QUIT) {
+                return -1;
+            }
+            
+            if (event.type == SDL_MOUSEBUTTONDOWN) {
+                int mouse_x, mouse_y;
+                SDL_GetMouseState(&mouse_x, &mouse_y);
+                
+                int clicked = hit_test_widgets(&screen, mouse_x, mouse_y);
+                if (clicked >= first_option && clicked < first_option + MAX_OPTIONS) {
+                    return clicked - first_option;
+                }
+            }
+        } while (SDL_PollEvent(&event));
+    }
+}
+
+void view_questions(SDL_Renderer* renderer, TTF_Font* font, GameState* game) {
+    SDL_Color WHITE = {255, 255, 255, 255};
+    SDL_Color BLUE = {0, 0, 128, 255};
+    SDL_Color LIGHT_BLUE = {100, 149, 237, 255};
+    SDL_Color GREEN = {0, 255, 0, 255};
+    SDL_Color RED = {255, 0, 0, 255};
+    
+    int current_index = 0;
+    bool quit = false;
+    SDL_Event event;
+    
+    // Text of the labels, refreshed for the current question before each frame
+    char question_num[50] = {0};
+    char option_texts[MAX_OPTIONS][150] = {{0}};
+    char correct_text[100] = {0};
+    
+    WidgetList screen = {0};
+    add_label(&screen, question_num, SCREEN_WIDTH/2 - 100, 50, WHITE);
+    int difficulty_label = add_label(&screen, "", SCREEN_WIDTH - 150, 50, WHITE);
+    int question_label = add_label(&screen, "", 50, 100, WHITE);
+    for (int i = 0; i < MAX_OPTIONS; i++) {
+        add_label(&screen, option_texts[i], 100, 200 + i * 50, WHITE);
+    }
+    add_label(&screen, correct_text, 50, 400, GREEN);
+    
+    // Navigation, Edit, Delete and Back buttons
+    int previous_button = add_button(&screen, "Previous", 50, 500, 150, 50, LIGHT_BLUE, WHITE);
+    int next_button = add_button(&screen, "Next", SCREEN_WIDTH - 200, 500, 150, 50, LIGHT_BLUE, WHITE);
+    int edit_button = add_button(&screen, "Edit", SCREEN_WIDTH/2 - 75, 500, 150, 50, LIGHT_BLUE, WHITE);
+    int delete_button = add_button(&screen, "Delete", SCREEN_WIDTH/2 - 75, 570, 150, 50, RED, WHITE);
+    int back_button = add_button(&screen, "Back", SCREEN_WIDTH/2 - 75, 640, 150, 50, LIGHT_BLUE, WHITE);
+    
+    bool redraw = true;
+    while (!quit && current_index < game->total_questions) {
+        redraw |= prune_toasts();
+        if (redraw) {
+            const Question* question = get_question(game, current_index);
+            
+            sprintf(question_num, "Question %d/%d", current_index + 1, game->total_questions);
+            const char* difficulty_str;
+            switch (question->difficulty) {
+                case DIFFICULTY_EASY: difficulty_str = "Easy"; break;
+                case DIFFICULTY_MEDIUM: difficulty_str = "Medium"; break;
+                case DIFFICULTY_HARD: difficulty_str = "Hard"; break;
+                default: difficulty_str = "Unknown";
+            }
+            screen.items[difficulty_label].text = difficulty_str;
+            screen.items[question_label].text = question_text(game, question);
+            for (int i = 0; i < MAX_OPTIONS; i++) {
+                sprintf(option_texts[i], "%d. %s", i + 1, option_text(game, question, i));
+            }
+            sprintf(correct_text, "Correct Answer: %d", question->correct_option + 1);
+            
+            screen.items[previous_button].visible = current_index > 0;
+            screen.items[next_button].visible = current_index < game->total_questions - 1;
+            
+            SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
+            SDL_RenderClear(renderer);
+            render_widgets(renderer, font, &screen);
+            render_toasts(renderer, font);
+            SDL_RenderPresent(renderer);
+            redraw = false;
+        }
+        
+        // Sleep until input arrives instead of redrawing an idle screen
+        if (!SDL_WaitEventTimeout(&event, toast_wait_timeout(IDLE_WAIT_MS))) {
+            continue;
+        }
+        do {
+            if (event_invalidates_screen(&event)) {
+                redraw = true;
+            }
+            
+            if (event.type == SDL_QUIT) {
+                quit = true;
+                break;
+            }
+            
+            if (event.type == SDL_MOUSEBUTTONDOWN) {
+                int mouse_x, mouse_y;
+                SDL_GetMouseState(&mouse_x, &mouse_y);
+                
+                int clicked = hit_test_widgets(&screen, mouse_x, mouse_y);
+                if (clicked == previous_button && current_index > 0) {
+                    current_index--;
+                } else if (clicked == next_button && current_index < game->total_questions - 1) {
+                    current_index++;
+                } else if (clicked == edit_button) {
+                    edit_question(renderer, font, game, current_index);
+                } else if (clicked == delete_button) {
+                    delete_question(renderer, font, game, current_index);
+                    if (current_index >= game->total_questions) {
+                        current_index = game->total_questions - 1;
+                    }
+                } else if (clicked == back_button) {
+                    quit = true;
+                }
+            }
+        } while (SDL_PollEvent(&event));
+    }
+}
+
+void edit_question(SDL_Renderer* renderer, TTF_Font* font, GameState* game, int index) {
+    SDL_Color WHITE = {255, 255, 255, 255};
+    SDL_Color BLUE = {0, 0, 128, 255};
+    SDL_Color LIGHT_BLUE = {100, 149, 237, 255};
+    SDL_Color GREEN = {0, 255, 0, 255};
+    SDL_Color RED = {255, 0, 0, 255};
+    
+    Question* question = question_bank_edit(game, index);
+    if (!question) {
+        show_toast("Could not edit question!", RED, 1500);
+        return;
+    }
+    
+    // Select what to edit
+    char button_texts[MAX_OPTIONS][50];
+    
+    WidgetList screen = {0};
+    add_label(&screen, "Edit Question", SCREEN_WIDTH/2 - 100, 50, WHITE);
+    int text_button = add_button(&screen, "Edit Question Text", SCREEN_WIDTH/2 - 150, 150, 300, 50, LIGHT_BLUE, WHITE);
+    int first_option = screen.count;
+    for (int i = 0; i < MAX_OPTIONS; i++) {
+        sprintf(button_texts[i], "Edit Option %d", i + 1);
+        add_button(&screen, button_texts[i], SCREEN_WIDTH/2 - 150, 220 + i * 70, 300, 50, LIGHT_BLUE, WHITE);
+    }
+    int correct_button = add_button(&screen, "Change Correct Answer", SCREEN_WIDTH/2 - 150, 500, 300, 50, LIGHT_BLUE, WHITE);
+    int done_button = add_button(&screen, "Done", SCREEN_WIDTH/2 - 150, 580, 300, 50, GREEN, WHITE);
+    
+    bool done = false;
+    bool redraw = true;
+    while (!done) {
+        redraw |= prune_toasts();
+        if (redraw) {
+            SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
+            SDL_RenderClear(renderer);
+            render_widgets(renderer, font, &screen);
+            render_toasts(renderer, font);
+            SDL_RenderPresent(renderer);
+            redraw = false;
+        }
+        
+        SDL_Event event;
+        
+        // Sleep until input arrives instead of redrawing an idle screen
+        if (!SDL_WaitEventTimeout(&event, toast_wait_timeout(IDLE_WAIT_MS))) {
+            continue;
+        }
+        do {
+            if (event_invalidates_screen(&event)) {
+                redraw = true;
+            }
+            
+            if (event.type == SDL_QUIT) {
+                done = true;
+                break;
+            }
+            
+            if (event.type == SDL_MOUSEBUTTONDOWN) {
+                int mouse_x, mouse_y;
+                SDL_GetMouseState(&mouse_x, &mouse_y);
+                
+                int clicked = hit_test_widgets(&screen, mouse_x, mouse_y);
+                if (clicked == text_button) {
+                    char new_question[MAX_QUESTION_LENGTH];
+                    get_text_input(renderer, font, new_question, MAX_QUESTION_LENGTH, "Enter new question text:");
+                    question->question = string_pool_intern(&game->strings, new_question);
+                } else if (clicked >= first_option && clicked < first_option + MAX_OPTIONS) {
+                    char new_option[MAX_OPTION_LENGTH];
+                    get_text_input(renderer, font, new_option, MAX_OPTION_LENGTH, "Enter new option text:");
+                    question->options[clicked - first_option] = string_pool_intern(&game->strings, new_option);
+                } else if (clicked == correct_button) {
+                    const char* options[MAX_OPTIONS];
+                    for (int i = 0; i < MAX_OPTIONS; i++) {
+                        options[i] = option_text(game, question, i);
+                    }
+                    int correct_option = select_correct_option(renderer, font, options);
+                    if (correct_option >= 0) {
+                        question->correct_option = correct_option;
+                    }
+                } else if (clicked == done_button) {
+                    done = true;
+                }
+            }
+        } while (SDL_PollEvent(&event));
+    }
+    
+    // Save changes
+    journal_append(game, JOURNAL_EDIT, index, question);
+    
+    // Confirmation
+    show_toast("Question Updated Successfully!", GREEN, 1500);
+}
+
+void delete_question(SDL_Renderer* renderer, TTF_Font* font, GameState* game, int index) {
+    SDL_Color WHITE = {255, 255, 255, 255};
+    SDL_Color BLUE = {0, 0, 128, 255};
+    SDL_Color RED = {255, 0, 0, 255};
+    SDL_Color GREEN = {0, 255, 0, 255};
+    
+    // Confirm deletion
+    SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
+    SDL_RenderClear(renderer);
+    
+    render_text(renderer, font, "Are you sure you want to delete this question?", SCREEN_WIDTH/2 - 250, 200, WHITE);
+    
+    render_button(renderer, font, "Yes", SCREEN_WIDTH/2 - 150, 300, 100, 50, RED, WHITE);
+    render_button(renderer, font, "No", SCREEN_WIDTH/2 + 50, 300, 100, 50, WHITE, BLUE);
+    
+    SDL_RenderPresent(renderer);
+    
+    ModalTarget buttons[] = {
+        {SCREEN_WIDTH/2 - 150, 300, 100, 50, 1, NULL, NULL}, // Yes
+        {SCREEN_WIDTH/2 + 50, 300, 100, 50, 0, NULL, NULL}   // No
+    };
+    bool confirmed = wait_modal(buttons, 2, 0) == 1;
+    
+    if (confirmed) {
+        // Remove from the bank, the last question takes its place
+        if (!question_bank_remove(game, index)) {
+            show_toast("Could not delete question!", RED, 1500);
+            return;
+        }
+        
+        // Save changes
+        journal_append(game, JOURNAL_DELETE, index, NULL);
+        
+        // Confirmation
+        show_toast("Question Deleted Successfully!", GREEN, 1500);
+    }
+}
+
+bool save_questions(GameState* game) {
+    // Repack only the strings still referenced, so edited-away text is dropped
+    StringPool strings = {0};
+    size_t records_size = (size_t)game->total_questions * QUESTION_RECORD_SIZE;
+    size_t buckets_size = (size_t)game->total_questions * 4;
+    unsigned char* records = malloc(records_size + buckets_size + 1);
+    if (!records) {
+        printf("Failed to save questions: out of memory\n");
+        return false;
+    }
+    for (int i = 0; i < game->total_questions; i++) {
+        const Question* question = get_question(game, i);
+        unsigned char* record = records + (size_t)i * QUESTION_RECORD_SIZE;
+        put_le32(record, string_pool_intern(&strings, question_text(game, question)));
+        for (int j = 0; j < MAX_OPTIONS; j++) {
+            put_le32(record + 4 + j * 4, string_pool_intern(&strings, option_text(game, question, j)));
+        }
+        put_le32(record + 20, (Uint32)question->correct_option);
+        put_le32(record + 24, (Uint32)question->difficulty);
+    }
+    
+    // Bucket table follows the records so a mapped bank needs no index pass
+    unsigned char* bucket_entry = records + records_size;
+    for (int d = DIFFICULTY_EASY; d <= DIFFICULTY_HARD; d++) {
+        const int* bucket = question_bank_bucket(game, d);
+        for (int i = 0; i < game->difficulty_count[d]; i++, bucket_entry += 4) {
+            put_le32(bucket_entry, (Uint32)bucket[i]);
+        }
+    }
+    buckets_size = bucket_entry - (records + records_size);
+    
+    // The string section keeps its leading empty string and is padded so records stay 4-byte aligned
+    Uint32 string_bytes = strings.used ? strings.used : 1;
+    string_bytes = (string_bytes + 3) & ~3u;
+    size_t body_size = string_bytes + records_size + buckets_size;
+    size_t size = QUESTION_FILE_HEADER_SIZE + body_size;
+    unsigned char* buffer = calloc(1, size);
+    if (!buffer) {
+        printf("Failed to save questions: out of memory\n");
+        free(records);
+        string_pool_free(&strings);
+        return false;
+    }
+    
+    unsigned char* body = buffer + QUESTION_FILE_HEADER_SIZE;
+    if (strings.used) {
+        memcpy(body, strings.data, strings.used);
+    }
+    memcpy(body + string_bytes, records, records_size + buckets_size);
+    
+    memcpy(buffer, QUESTION_FILE_MAGIC, 4);
+    put_le32(buffer + 4, QUESTION_FILE_VERSION);
+    put_le32(buffer + 8, (Uint32)game->total_questions);
+    put_le32(buffer + 12, string_bytes);
+    Uint32 checksum = checksum_bytes(body, body_size);
+    put_le32(buffer + 16, checksum);
+    for (int d = DIFFICULTY_EASY; d <= DIFFICULTY_HARD; d++) {
+        put_le32(buffer + 20 + d * 4, (Uint32)game->difficulty_count[d]);
+    }
+    
+    free(records);
+    string_pool_free(&strings);
+    
+    // The worker replaces the file and then starts a fresh journal for it. A mapped
+    // bank keeps reading the old file, which the rename leaves intact, and its overlay.
+    unsigned char header[JOURNAL_HEADER_SIZE];
+    memcpy(header, JOURNAL_MAGIC, 4);
+    put_le32(header + 4, checksum);
+    io_save_file(QUESTION_FILE, buffer, size, IO_LOG_JOURNAL, header);
+    game->bank_checksum = checksum;
+    game->journal_size = JOURNAL_HEADER_SIZE;
+    return true;
+}
+
+void load_questions(GameState* game) {
+    if (load_question_file(game, QUESTION_FILE)) {
+        return;
+    }
+    
+    // Keep a malformed bank aside rather than letting a save overwrite it, then try the backup
+    if (rename(QUESTION_FILE, QUESTION_FILE ".corrupt") == 0) {
+        printf("%s is malformed, moved it to %s.corrupt\n", QUESTION_FILE, QUESTION_FILE);
+    }
+    if (load_question_file(game, QUESTION_FILE ".bak")) {
+        printf("Restored questions from %s.bak\n", QUESTION_FILE);
+    }
+}
+
+bool load_question_file(GameState* game, const char* path) {
+    // Read the whole file in one go and parse it from memory
+    size_t size;
+    unsigned char* data = read_file(path, &size);
+    if (!data) {
+        return false;
+    }
+    
+    bool loaded;
+    if (size >= 4 && memcmp(data, QUESTION_FILE_MAGIC, 4) == 0) {
+        loaded = load_question_container(game, data, size);
+    } else {
+        loaded = load_legacy_questions(game, data, size);
+    }
+    free(data);
+    
+    if (!loaded) {
+        question_bank_free(game);
+    }
+    return loaded;
+}
+
+bool map_questions(GameState* game) {
+#if defined(_WIN32) || SDL_BYTEORDER != SDL_LIL_ENDIAN
+    // Records are used in place as Question structs, which needs a little-endian POSIX host
+    return false;
+#else
+    int fd = open(QUESTION_FILE, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < QUESTION_FILE_HEADER_SIZE) {
+        close(fd);
+        return false;
+    }
+    size_t size = st.st_size;
+    const unsigned char* data = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        printf("Failed to map %s\n", QUESTION_FILE);
+        return false;
+    }
+    
+    // Only the header is checked up front, so startup does not depend on bank size.
+    // Text offsets and bucket entries are bounds-checked when they are read.
+    Uint32 count = get_le32(data + 8);
+    Uint32 string_bytes = get_le32(data + 12);
+    Uint64 bucket_total = (Uint64)get_le32(data + 20) + get_le32(data + 24) + get_le32(data + 28);
+    Uint64 body_size = (Uint64)string_bytes + (Uint64)count * (QUESTION_RECORD_SIZE + 4);
+    const char* strings = (const char*)data + QUESTION_FILE_HEADER_SIZE;
+    if (memcmp(data, QUESTION_FILE_MAGIC, 4) != 0 || get_le32(data + 4) != QUESTION_FILE_VERSION ||
+        body_size != size - QUESTION_FILE_HEADER_SIZE || bucket_total != count ||
+        string_bytes == 0 || string_bytes % 4 != 0 ||
+        strings[0] != '\0' || strings[string_bytes - 1] != '\0') {
+        munmap((void*)data, size);
+        return false;
+    }
+    
+    game->mapped_file = data;
+    game->mapped_size = size;
+    game->mapped_questions = (const Question*)(strings + string_bytes);
+    const int* bucket = (const int*)(strings + string_bytes + (size_t)count * QUESTION_RECORD_SIZE);
+    for (int d = DIFFICULTY_EASY; d <= DIFFICULTY_HARD; d++) {
+        game->mapped_index[d] = bucket;
+        game->difficulty_count[d] = (int)get_le32(data + 20 + d * 4);
+        bucket += game->difficulty_count[d];
+    }
+    game->mapped_count = (int)count;
+    game->total_questions = (int)count;
+    game->strings.base = strings;
+    game->strings.base_size = string_bytes;
+    game->bank_checksum = get_le32(data + 16);
+    return true;
+#endif
+}
+
+bool load_question_container(GameState* game, const unsigned char* data, size_t size) {
+    // Version 2 adds bucket counts to the header and a bucket table after the records,
+    // which is only used when mapping; loading rebuilds the buckets as records are added
+    if (size < QUESTION_FILE_V1_HEADER_SIZE) {
+        return false;
+    }
+    Uint32 version = get_le32(data + 4);
+    size_t header_size = version == 1 ? QUESTION_FILE_V1_HEADER_SIZE : QUESTION_FILE_HEADER_SIZE;
+    Uint32 bucket_entry_size = version == 1 ? 0 : 4;
+    if ((version != 1 && version != QUESTION_FILE_VERSION) || size < header_size) {
+        return false;
+    }
+    
+    // The header sizes must account for the file exactly
+    Uint32 count = get_le32(data + 8);
+    Uint32 string_bytes = get_le32(data + 12);
+    Uint64 body_size = (Uint64)string_bytes + (Uint64)count * (QUESTION_RECORD_SIZE + bucket_entry_size);
+    if (body_size != size - header_size) {
+        return false;
+    }
+    
+    const unsigned char* body = data + header_size;
+    if (checksum_bytes(body, (size_t)body_size) != get_le32(data + 16)) {
+        return false;
+    }
+    
+    char* strings = malloc(string_bytes ? string_bytes : 1);
+    if (!strings) {
+        return false;
+    }
+    memcpy(strings, body, string_bytes);
+    if (!string_pool_adopt(&game->strings, strings, string_bytes)) {
+        free(strings);
+        return false;
+    }
+    
+    // Validate and add each record in a single pass
+    if (!question_bank_reserve(game, (int)count)) {
+        return false;
+    }
+    const unsigned char* record = body + string_bytes;
+    for (Uint32 i = 0; i < count; i++, record += QUESTION_RECORD_SIZE) {
+        Question question = {0};
+        question.question = get_le32(record);
+        for (int j = 0; j < MAX_OPTIONS; j++) {
+            question.options[j] = get_le32(record + 4 + j * 4);
+        }
+        question.correct_option = (int)get_le32(record + 20);
+        question.difficulty = (int)get_le32(record + 24);
+        
+        if (question.correct_option < 0 || question.correct_option >= MAX_OPTIONS ||
+            question.difficulty < DIFFICULTY_EASY || question.difficulty > DIFFICULTY_HARD) {
+            return false;
+        }
+        
+        // Every offset must be the start of a string in the string section
+        for (int j = -1; j < MAX_OPTIONS; j++) {
+            Uint32 offset = j < 0 ? question.question : question.options[j];
+            if (offset >= string_bytes || (offset > 0 && strings[offset - 1] != '\0')) {
+                return false;
+            }
+        }
+        question_bank_add(game, &question);
+    }
+    
+    // The header's bucket counts are what a mapped load trusts, so they must match too
+    for (int d = DIFFICULTY_EASY; d <= DIFFICULTY_HARD && version != 1; d++) {
+        if (get_le32(data + 20 + d * 4) != (Uint32)game->difficulty_count[d]) {
+            return false;
+        }
+    }
+    game->bank_checksum = get_le32(data + 16);
+    return true;
+}
+
+bool load_legacy_questions(GameState* game, const unsigned char* data, size_t size) {
+    // Older files: a native int count followed by raw QuestionRecord structs
+    int count;
+    if (size < sizeof(int)) {
+        return false;
+    }
+    memcpy(&count, data, sizeof(int));
+    if (count < 0 || (size - sizeof(int)) / sizeof(QuestionRecord) != (size_t)count ||
+        (size - sizeof(int)) % sizeof(QuestionRecord) != 0) {
+        return false;
+    }
+    
+    QuestionRecord record;
+    for (int i = 0; i < count; i++) {
+        memcpy(&record, data + sizeof(int) + i * sizeof(QuestionRecord), sizeof(QuestionRecord));
+        record.question[MAX_QUESTION_LENGTH - 1] = '\0';
+        
+        Question question = {0};
+        question.question = string_pool_intern(&game->strings, record.question);
+        for (int j = 0; j < MAX_OPTIONS; j++) {
+            record.options[j][MAX_OPTION_LENGTH - 1] = '\0';
+            question.options[j] = string_pool_intern(&game->strings, record.options[j]);
+        }
+        question.correct_option = record.correct_option;
+        question.difficulty = record.difficulty;
+        if (question.correct_option < 0 || question.correct_option >= MAX_OPTIONS ||
+            question.difficulty < DIFFICULTY_EASY || question.difficulty > DIFFICULTY_HARD ||
+            question_bank_add(game, &question) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void journal_open(GameState* game) {
+    // Replay edits left by a session that did not get to compact, if they apply to this bank
+    size_t size;
+    unsigned char* data = read_file(JOURNAL_FILE, &size);
+    if (data && size >= JOURNAL_HEADER_SIZE && memcmp(data, JOURNAL_MAGIC, 4) == 0 &&
+        get_le32(data + 4) == game->bank_checksum && size > JOURNAL_HEADER_SIZE) {
+        if (!journal_replay(game, data + JOURNAL_HEADER_SIZE, size - JOURNAL_HEADER_SIZE)) {
+            printf("%s ends in a damaged record, keeping the edits before it\n", JOURNAL_FILE);
+        }
+        free(data);
+        
+        // Fold the replayed edits in now, which also drops any torn record at the end.
+        // If that save fails the journal is reopened and kept.
+        if (!save_questions(game)) {
+            io_open_log(IO_LOG_JOURNAL);
+            game->journal_size = (long)size;
+        }
+        return;
+    }
+    free(data);
+    journal_reset(game);
+}
+
+bool journal_replay(GameState* game, const unsigned char* data, size_t size) {
+    // Each payload: op, index, correct option, difficulty and, for adds and edits,
+    // the question and option strings
+    size_t pos = 0;
+    size_t payload_size;
+    const unsigned char* payload;
+    while ((payload = log_next_record(data, size, &pos, &payload_size))) {
+        if (payload_size < 16) {
+            return false;
+        }
+        
+        int op = (int)get_le32(payload);
+        int index = (int)get_le32(payload + 4);
+        if (op == JOURNAL_DELETE) {
+            if (index < 0 || index >= game->total_questions || !question_bank_remove(game, index)) {
+                return false;
+            }
+            continue;
+        }
+        
+        // Five NUL-terminated strings follow the fixed fields
+        const char* texts[MAX_OPTIONS + 1];
+        const char* text = (const char*)payload + 16;
+        const char* end = (const char*)payload + payload_size;
+        for (int i = 0; i <= MAX_OPTIONS; i++) {
+            const char* nul = text < end ? memchr(text, '\0', end - text) : NULL;
+            if (!nul) {
+                return false;
+            }
+            texts[i] = text;
+            text = nul + 1;
+        }
+        
+        Question question = {0};
+        question.question = string_pool_intern(&game->strings, texts[0]);
+        for (int i = 0; i < MAX_OPTIONS; i++) {
+            question.options[i] = string_pool_intern(&game->strings, texts[i + 1]);
+        }
+        question.correct_option = (int)get_le32(payload + 8);
+        question.difficulty = (int)get_le32(payload + 12);
+        
+        if (op == JOURNAL_ADD) {
+            if (question_bank_add(game, &question) < 0) {
+                return false;
+            }
+        } else if (op == JOURNAL_EDIT && index >= 0 && index < game->total_questions) {
+            // Edits never move a question between difficulties
+            Question* target = question_bank_edit(game, index);
+            if (!target) {
+                return false;
+            }
+            question.difficulty = target->difficulty;
+            *target = question;
+        } else {
+            return false;
+        }
+    }
+    return pos == size;
+}
+
+void journal_reset(GameState* game) {
+    // Start an empty journal for the bank file as it is now
+    unsigned char header[JOURNAL_HEADER_SIZE];
+    memcpy(header, JOURNAL_MAGIC, 4);
+    put_le32(header + 4, game->bank_checksum);
+    io_reset_log(IO_LOG_JOURNAL, header);
+    game->journal_size = JOURNAL_HEADER_SIZE;
+}
+
+void journal_append(GameState* game, int op, int index, const Question* question) {
+    // Without a journal the only way to persist the edit is a full save
+    if (io_log_failed(IO_LOG_JOURNAL)) {
+        save_questions(game);
+        return;
+    }
+    
+    unsigned char payload[16 + MAX_QUESTION_LENGTH + MAX_OPTIONS * MAX_OPTION_LENGTH];
+    put_le32(payload, (Uint32)op);
+    put_le32(payload + 4, (Uint32)index);
+    put_le32(payload + 8, question ? (Uint32)question->correct_option : 0);
+    put_le32(payload + 12, question ? (Uint32)question->difficulty : 0);
+    size_t payload_size = 16;
+    if (question) {
+        // Text from the input screens always fits its MAX_*_LENGTH buffer
+        const char* texts[MAX_OPTIONS + 1] = {question_text(game, question)};
+        size_t limits[MAX_OPTIONS + 1] = {MAX_QUESTION_LENGTH};
+        for (int i = 0; i < MAX_OPTIONS; i++) {
+            texts[i + 1] = option_text(game, question, i);
+            limits[i + 1] = MAX_OPTION_LENGTH;
+        }
+        for (int i = 0; i <= MAX_OPTIONS; i++) {
+            size_t length = strnlen(texts[i], limits[i] - 1);
+            memcpy(payload + payload_size, texts[i], length);
+            payload[payload_size + length] = '\0';
+            payload_size += length + 1;
+        }
+    }
+    
+    // One small append per edit, the bank file itself is left alone
+    io_append(IO_LOG_JOURNAL, payload, payload_size);
+    game->journal_size += (long)(8 + payload_size);
+    
+    if (game->journal_size > JOURNAL_COMPACT_BYTES) {
+        journal_compact(game);
+    }
+}
+
+void journal_compact(GameState* game) {
+    // Rewrite the bank with every journaled edit applied, which also starts a fresh journal
+    if (game->journal_size > JOURNAL_HEADER_SIZE) {
+        save_questions(game);
+    }
+}
+
+void journal_close(GameState* game) {
+    journal_compact(game);
+}
+
+bool save_players(GameState* game) {
+    size_t size = sizeof(int) + game->total_players * sizeof(Player);
+    unsigned char* buffer = malloc(size);
+    if (!buffer) {
+        printf("Failed to save players: out of memory\n");
+        return false;
+    }
+    memcpy(buffer, &game->total_players, sizeof(int));
+    memcpy(buffer + sizeof(int), game->players, game->total_players * sizeof(Player));
+    
+    // The worker replaces the file and then starts a fresh score log for it
+    game->players_checksum = checksum_bytes(buffer, size);
+    unsigned char header[SCORE_LOG_HEADER_SIZE];
+    memcpy(header, SCORE_LOG_MAGIC, 4);
+    put_le32(header + 4, game->players_checksum);
+    io_save_file(PLAYER_FILE, buffer, size, IO_LOG_SCORES, header);
+    game->score_log_size = SCORE_LOG_HEADER_SIZE;
+    return true;
+}
+
+void load_players(GameState* game) {
+    if (!load_player_file(game, PLAYER_FILE) && load_player_file(game, PLAYER_FILE ".bak")) {
+        printf("Restored players from %s.bak\n", PLAYER_FILE);
+    }
+}
+
+bool load_player_file(GameState* game, const char* path) {
+    size_t size;
+    unsigned char* data = read_file(path, &size);
+    if (!data) {
+        return false;
+    }
+    
+    // The count must account for the file exactly
+    int count = -1;
+    if (size >= sizeof(int)) {
+        memcpy(&count, data, sizeof(int));
+    }
+    bool valid = count >= 0 && (size - sizeof(int)) % sizeof(Player) == 0 &&
+                 (size - sizeof(int)) / sizeof(Player) == (size_t)count;
+    if (!valid) {
+        printf("%s is malformed\n", path);
+        free(data);
+        return false;
+    }
+    
+    // Player IDs are positions in the file, then the name table is built once
+    int slot_count = PLAYER_TABLE_INITIAL_SLOTS;
+    while (count * 4 >= slot_count * 3) {
+        slot_count *= 2;
+    }
+    bool loaded = player_registry_reserve(game, count);
+    if (loaded) {
+        game->total_players = count;
+        memcpy(game->players, data + sizeof(int), count * sizeof(Player));
+        for (int i = 0; i < count; i++) {
+            game->players[i].name[MAX_NAME_LENGTH - 1] = '\0';
+        }
+        loaded = player_registry_rehash(game, slot_count);
+        if (!loaded) {
+            game->total_players = 0;
+        }
+    }
+    if (loaded) {
+        game->players_checksum = checksum_bytes(data, size);
+    }
+    free(data);
+    return loaded;
+}
+
+void score_log_open(GameState* game) {
+    // Replay scores left by a session that did not get to compact, if they extend this player file
+    size_t size;
+    unsigned char* data = read_file(SCORE_LOG_FILE, &size);
+    if (data && size > SCORE_LOG_HEADER_SIZE && memcmp(data, SCORE_LOG_MAGIC, 4) == 0 &&
+        get_le32(data + 4) == game->players_checksum) {
+        if (!score_log_replay(game, data + SCORE_LOG_HEADER_SIZE, size - SCORE_LOG_HEADER_SIZE)) {
+            printf("%s ends in a damaged record, keeping the scores before it\n", SCORE_LOG_FILE);
+        }
+        free(data);
+        
+        if (!save_players(game)) {
+            io_open_log(IO_LOG_SCORES);
+            game->score_log_size = (long)size;
+        }
+        return;
+    }
+    free(data);
+    score_log_reset(game);
+}
+
+bool score_log_replay(GameState* game, const unsigned char* data, size_t size) {
+    // Each payload: difficulty, score, then the player's name. New names are registered
+    // in log order, so they get the same IDs they had when the scores were recorded.
+    size_t pos = 0;
+    size_t payload_size;
+    const unsigned char* payload;
+    while ((payload = log_next_record(data, size, &pos, &payload_size))) {
+        const char* name = (const char*)payload + 8;
+        if (payload_size < 9 || payload[payload_size - 1] != '\0') {
+            return false;
+        }
+        int difficulty = (int)get_le32(payload);
+        if (difficulty < DIFFICULTY_EASY || difficulty > DIFFICULTY_HARD) {
+            return false;
+        }
+        int id = register_player(game, name);
+        if (id < 0) {
+            return false;
+        }
+        game->players[id].scores[difficulty] = (int)get_le32(payload + 4);
+    }
+    return pos == size;
+}
+
+void score_log_reset(GameState* game) {
+    // Start an empty log for the player file as it is now
+    unsigned char header[SCORE_LOG_HEADER_SIZE];
+    memcpy(header, SCORE_LOG_MAGIC, 4);
+    put_le32(header + 4, game->players_checksum);
+    io_reset_log(IO_LOG_SCORES, header);
+    game->score_log_size = SCORE_LOG_HEADER_SIZE;
+}
+
+void score_log_append(GameState* game, int id, int difficulty, int score) {
+    // Without a log the only way to persist the score is a full save
+    if (io_log_failed(IO_LOG_SCORES)) {
+        save_players(game);
+        return;
+    }
+    
+    unsigned char payload[8 + MAX_NAME_LENGTH];
+    put_le32(payload, (Uint32)difficulty);
+    put_le32(payload + 4, (Uint32)score);
+    size_t name_length = strlen(game->players[id].name);
+    memcpy(payload + 8, game->players[id].name, name_length + 1);
+    size_t payload_size = 8 + name_length + 1;
+    
+    io_append(IO_LOG_SCORES, payload, payload_size);
+    game->score_log_size += (long)(8 + payload_size);
+    
+    if (game->score_log_size > SCORE_LOG_COMPACT_BYTES) {
+        score_log_compact(game);
+    }
+}
+
+void score_log_compact(GameState* game) {
+    // Rewrite the player file with every logged score applied, which also starts a fresh log
+    if (game->score_log_size > SCORE_LOG_HEADER_SIZE) {
+        save_players(game);
+    }
+}
+
+void score_log_close(GameState* game) {
+    score_log_compact(game);
+}
+
+void attempt_history_open(GameState* game) {
+    // Load every recorded attempt, then keep the file open to append new ones
+    size_t size;
+    unsigned char* data = read_file(ATTEMPT_FILE, &size);
+    if (data && (size < ATTEMPT_FILE_HEADER_SIZE || memcmp(data, ATTEMPT_FILE_MAGIC, 4) != 0 ||
+                 get_le32(data + 4) != ATTEMPT_FILE_VERSION)) {
+        // Keep an unreadable history aside rather than appending to it
+        free(data);
+        data = NULL;
+        if (rename(ATTEMPT_FILE, ATTEMPT_FILE ".corrupt") == 0) {
+            printf("%s is malformed, moved it to %s.corrupt\n", ATTEMPT_FILE, ATTEMPT_FILE);
+        }
+    }
+    
+    if (data) {
+        size_t valid = ATTEMPT_FILE_HEADER_SIZE +
+                       attempt_history_replay(game, data + ATTEMPT_FILE_HEADER_SIZE, size - ATTEMPT_FILE_HEADER_SIZE);
+        
+        // Cut off a damaged tail so new attempts are not appended after it; the
+        // file is reopened only once that rewrite has succeeded
+        if (valid < size) {
+            printf("%s ends in a damaged record, keeping the attempts before it\n", ATTEMPT_FILE);
+            io_save_file(ATTEMPT_FILE, data, valid, IO_LOG_ATTEMPTS, NULL);
+        } else {
+            free(data);
+            io_open_log(IO_LOG_ATTEMPTS);
+        }
+    } else {
+        unsigned char header[ATTEMPT_FILE_HEADER_SIZE];
+        memcpy(header, ATTEMPT_FILE_MAGIC, 4);
+        put_le32(header + 4, ATTEMPT_FILE_VERSION);
+        io_reset_log(IO_LOG_ATTEMPTS, header);
+    }
+}
+
+size_t attempt_history_replay(GameState* game, const unsigned char* data, size_t size) {
+    // Each payload: timestamp (low word, high word), difficulty, score, correct mask,
+    // question count, answer time, then the player's name. Returns the bytes of valid attempts.
+    size_t pos = 0;
+    size_t valid = 0;
+    size_t payload_size;
+    const unsigned char* payload;
+    while ((payload = log_next_record(data, size, &pos, &payload_size))) {
+        const char* name = (const char*)payload + 28;
+        if (payload_size < 29 || payload[payload_size - 1] != '\0') {
+            break;
+        }
+        
+        Attempt attempt;
+        attempt.timestamp = (Sint64)((Uint64)get_le32(payload) | ((Uint64)get_le32(payload + 4) << 32));
+        attempt.difficulty = (int)get_le32(payload + 8);
+        attempt.score = (int)get_le32(payload + 12);
+        attempt.correct_mask = (Uint16)get_le32(payload + 16);
+        attempt.question_count = (int)get_le32(payload + 20);
+        attempt.answer_ms = get_le32(payload + 24);
+        if (attempt.difficulty < DIFFICULTY_EASY || attempt.difficulty > DIFFICULTY_HARD ||
+            attempt.question_count < 0 || attempt.question_count > QUESTIONS_PER_LEVEL) {
+            break;
+        }
+        
+        // Attempts name their player, so they survive the player file being restored from a backup
+        attempt.player = register_player(game, name);
+        if (attempt.player < 0) {
+            break;
+        }
+        attempt_history_add(&game->attempts, &attempt);
+        valid = pos;
+    }
+    return valid;
+}
+
+bool attempt_history_reserve(AttemptHistory* history, int capacity) {
+    if (capacity <= history->capacity) {
+        return true;
+    }
+    
+    int new_capacity = history->capacity ? history->capacity : INITIAL_ATTEMPT_CAPACITY;
+    while (new_capacity < capacity) {
+        new_capacity *= 2;
+    }
+    
+    // All columns share one block, widest first so each column stays aligned
+    size_t row_size = sizeof(Sint64) + sizeof(int) + sizeof(Uint32) + sizeof(Sint16) + sizeof(Uint16) + 2 * sizeof(Uint8);
+    unsigned char* block = malloc((size_t)new_capacity * row_size);
+    if (!block) {
+        printf("Failed to grow attempt history to %d attempts!\n", new_capacity);
+        return false;
+    }
+    
+    AttemptHistory grown = *history;
+    grown.timestamp = (Sint64*)block;
+    grown.player = (int*)(grown.timestamp + new_capacity);
+    grown.answer_ms = (Uint32*)(grown.player + new_capacity);
+    grown.score = (Sint16*)(grown.answer_ms + new_capacity);
+    grown.correct_mask = (Uint16*)(grown.score + new_capacity);
+    grown.difficulty = (Uint8*)(grown.correct_mask + new_capacity);
+    grown.question_count = grown.difficulty + new_capacity;
+    grown.capacity = new_capacity;
+    
+    if (history->count > 0) {
+        memcpy(grown.timestamp, history->timestamp, history->count * sizeof(Sint64));
+        memcpy(grown.player, history->player, history->count * sizeof(int));
+        memcpy(grown.answer_ms, history->answer_ms, history->count * sizeof(Uint32));
+        memcpy(grown.score, history->score, history->count * sizeof(Sint16));
+        memcpy(grown.correct_mask, history->correct_mask, history->count * sizeof(Uint16));
+        memcpy(grown.difficulty, history->difficulty, history->count * sizeof(Uint8));
+        memcpy(grown.question_count, history->question_count, history->count * sizeof(Uint8));
+    }
+    free(history->timestamp);
+    *history = grown;
+    return true;
+}
+
+void attempt_history_add(AttemptHistory* history, const Attempt* attempt) {
+    if (!attempt_history_reserve(history, history->count + 1)) {
+        return;
+    }
+    
+    int row = history->count++;
+    history->timestamp[row] = attempt->timestamp;
+    history->player[row] = attempt->player;
+    history->answer_ms[row] = attempt->answer_ms;
+    history->score[row] = (Sint16)attempt->score;
+    history->correct_mask[row] = attempt->correct_mask;
+    history->difficulty[row] = (Uint8)attempt->difficulty;
+    history->question_count[row] = (Uint8)attempt->question_count;
+}
+
+void attempt_history_append(GameState* game, const Attempt* attempt) {
+    attempt_history_add(&game->attempts, attempt);
+    
+    unsigned char payload[28 + MAX_NAME_LENGTH];
+    put_le32(payload, (Uint32)((Uint64)attempt->timestamp & 0xFFFFFFFF));
+    put_le32(payload + 4, (Uint32)((Uint64)attempt->timestamp >> 32));
+    put_le32(payload + 8, (Uint32)attempt->difficulty);
+    put_le32(payload + 12, (Uint32)attempt->score);
+    put_le32(payload + 16, attempt->correct_mask);
+    put_le32(payload + 20, (Uint32)attempt->question_count);
+    put_le32(payload + 24, attempt->answer_ms);
+    const char* name = game->players[attempt->player].name;
+    size_t name_length = strlen(name);
+    memcpy(payload + 28, name, name_length + 1);
+    
+    io_append(IO_LOG_ATTEMPTS, payload, 28 + name_length + 1);
+}
+
+void attempt_stats_all(const AttemptHistory* history, int player, AttemptStats stats[ATTEMPT_STATS_OVERALL + 1]) {
+    // One pass over the columns for every difficulty, with branch-free masked sums so the loop
+    // vectorizes. Rows are in time order, so each trend is fitted against the row number and
+    // rescaled to the player's own attempts.
+    Sint64 attempts[4] = {0}, sum[4] = {0}, sum_x[4] = {0}, sum_xx[4] = {0}, sum_xy[4] = {0};
+    Sint64 correct[4] = {0}, asked[4] = {0}, answer_ms[4] = {0};
+    int best[4], first[4], last[4];
+    for (int d = 0; d <= ATTEMPT_STATS_OVERALL; d++) {
+        best[d] = SDL_MIN_SINT16;
+        first[d] = history->count;
+        last[d] = -1;
+    }
+    for (int i = 0; i < history->count; i++) {
+        int mine = history->player[i] == player;
+        int score = history->score[i];
+        
+        // Correct answers are the set bits of the mask
+        Uint32 bits = history->correct_mask[i];
+        bits = bits - ((bits >> 1) & 0x5555);
+        bits = (bits & 0x3333) + ((bits >> 2) & 0x3333);
+        bits = (bits + (bits >> 4)) & 0x0F0F;
+        bits = (bits + (bits >> 8)) & 0x1F;
+        
+        for (int d = DIFFICULTY_EASY; d <= DIFFICULTY_HARD; d++) {
+            int match = mine & (history->difficulty[i] == d);
+            attempts[d] += match;
+            sum[d] += match * score;
+            sum_x[d] += (Sint64)match * i;
+            sum_xx[d] += (Sint64)match * i * i;
+            sum_xy[d] += (Sint64)match * i * score;
+            correct[d] += match * (int)bits;
+            asked[d] += match * history->question_count[i];
+            answer_ms[d] += (Sint64)match * history->answer_ms[i];
+            best[d] = (match & (score > best[d])) ? score : best[d];
+            first[d] = (match & (i < first[d])) ? i : first[d];
+            last[d] = match ? i : last[d];
+        }
+    }
+    
+    // Every attempt has one difficulty, so the overall sums are those of the three combined
+    int all = ATTEMPT_STATS_OVERALL;
+    for (int d = DIFFICULTY_EASY; d <= DIFFICULTY_HARD; d++) {
+        attempts[all] += attempts[d];
+        sum[all] += sum[d];
+        sum_x[all] += sum_x[d];
+        sum_xx[all] += sum_xx[d];
+        sum_xy[all] += sum_xy[d];
+        correct[all] += correct[d];
+        asked[all] += asked[d];
+        answer_ms[all] += answer_ms[d];
+        best[all] = SDL_max(best[all], best[d]);
+        first[all] = SDL_min(first[all], first[d]);
+        last[all] = SDL_max(last[all], last[d]);
+    }
+    
+    for (int d = 0; d <= ATTEMPT_STATS_OVERALL; d++) {
+        AttemptStats* out = &stats[d];
+        memset(out, 0, sizeof(AttemptStats));
+        out->attempts = (int)attempts[d];
+        if (attempts[d] == 0) {
+            continue;
+        }
+        out->best = best[d];
+        out->mean = (float)sum[d] / attempts[d];
+        if (asked[d] > 0) {
+            out->accuracy = (float)correct[d] / asked[d];
+            out->mean_answer_ms = (float)answer_ms[d] / asked[d];
+        }
+        double spread = (double)attempts[d] * sum_xx[d] - (double)sum_x[d] * sum_x[d];
+        if (attempts[d] > 1 && spread > 0) {
+            double slope = ((double)attempts[d] * sum_xy[d] - (double)sum_x[d] * sum[d]) / spread;
+            out->trend = (float)(slope * (last[d] - first[d]) / (attempts[d] - 1));
+        }
+    }
+}
+
+void attempt_history_close(GameState* game) {
+    free(game->attempts.timestamp);
+    memset(&game->attempts, 0, sizeof(AttemptHistory));
+}
+
+bool leaderboard_init(Leaderboard* board, int min_score, int max_score) {
+    memset(board, 0, sizeof(Leaderboard));
+    int range = max_score - min_score + 1;
+    board->head = malloc(range * sizeof(int));
+    board->tail = malloc(range * sizeof(int));
+    board->fenwick = calloc(range + 1, sizeof(int));
+    if (!board->head || !board->tail || !board->fenwick) {
+        printf("Failed to allocate leaderboard!\n");
+        leaderboard_destroy(board);
+        return false;
+    }
+    for (int i = 0; i < range; i++) {
+        board->head[i] = -1;
+        board->tail[i] = -1;
+    }
+    board->min_score = min_score;
+    board->max_score = max_score;
+    board->range = range;
+    return true;
+}
+
+bool leaderboard_reserve(Leaderboard* board, int player_capacity) {
+    if (player_capacity <= board->player_capacity) {
+        return true;
+    }
+    
+    int new_capacity = board->player_capacity ? board->player_capacity : INITIAL_PLAYER_CAPACITY;
+    while (new_capacity < player_capacity) {
+        new_capacity *= 2;
+    }
+    int* score = realloc(board->score, new_capacity * sizeof(int));
+    if (score) {
+        board->score = score;
+    }
+    int* next = realloc(board->next, new_capacity * sizeof(int));
+    if (next) {
+        board->next = next;
+    }
+    int* prev = realloc(board->prev, new_capacity * sizeof(int));
+    if (prev) {
+        board->prev = prev;
+    }
+    if (!score || !next || !prev) {
+        printf("Failed to grow leaderboard to %d players!\n", new_capacity);
+        return false;
+    }
+    
+    // New players start unranked
+    for (int i = board->player_capacity; i < new_capacity; i++) {
+        board->score[i] = board->min_score - 1;
+    }
+    board->player_capacity = new_capacity;
+    return true;
+}
+
+void leaderboard_fenwick_add(Leaderboard* board, int bucket, int delta) {
+    for (int i = bucket + 1; i <= board->range; i += i & -i) {
+        board->fenwick[i] += delta;
+    }
+}
+
+void leaderboard_set(Leaderboard* board, int player, int score) {
+    if (board->range == 0 || !leaderboard_reserve(board, player + 1)) {
+        return;
+    }
+    
+    // Scores from old files may fall outside the range, rank them at its ends
+    if (score < board->min_score) score = board->min_score;
+    if (score > board->max_score) score = board->max_score;
+    
+    // Take the player out of their current bucket
+    if (board->score[player] >= board->min_score) {
+        int bucket = board->max_score - board->score[player];
+        int prev = board->prev[player];
+        int next = board->next[player];
+        if (prev >= 0) board->next[prev] = next; else board->head[bucket] = next;
+        if (next >= 0) board->prev[next] = prev; else board->tail[bucket] = prev;
+        leaderboard_fenwick_add(board, bucket, -1);
+        board->total--;
+    }
+    
+    // Ties keep the order they reached the score in
+    int bucket = board->max_score - score;
+    board->score[player] = score;
+    board->prev[player] = board->tail[bucket];
+    board->next[player] = -1;
+    if (board->tail[bucket] >= 0) board->next[board->tail[bucket]] = player; else board->head[bucket] = player;
+    board->tail[bucket] = player;
+    leaderboard_fenwick_add(board, bucket, 1);
+    board->total++;
+}
+
+int leaderboard_rank(const Leaderboard* board, int player) {
+    // 1 plus the players in higher buckets, so tied players share a rank; 0 when unranked
+    if (player >= board->player_capacity || board->score[player] < board->min_score) {
+        return 0;
+    }
+    int above = 0;
+    for (int i = board->max_score - board->score[player]; i > 0; i -= i & -i) {
+        above += board->fenwick[i];
+    }
+    return above + 1;
+}
+
+int leaderboard_list(const Leaderboard* board, int start, int* out, int max_count) {
+    // Descend the Fenwick tree to the bucket holding the player at position start
+    int bucket = 0;
+    int before = 0;
+    int step = 1;
+    while (step * 2 <= board->range) {
+        step *= 2;
+    }
+    for (; board->range > 0 && step > 0; step /= 2) {
+        if (bucket + step <= board->range && before + board->fenwick[bucket + step] <= start) {
+            bucket += step;
+            before += board->fenwick[bucket];
+        }
+    }
+    
+    // Then walk the buckets from there, skipping the players ahead of start in the first one
+    int count = 0;
+    int player = bucket < board->range ? board->head[bucket] : -1;
+    for (; player >= 0 && before < start; before++) {
+        player = board->next[player];
+    }
+    while (count < max_count && bucket < board->range) {
+        if (player < 0) {
+            if (++bucket < board->range) {
+                player = board->head[bucket];
+            }
+            continue;
+        }
+        out[count++] = player;
+        player = board->next[player];
+    }
+    return count;
+}
+
+void leaderboard_destroy(Leaderboard* board) {
+    free(board->head);
+    free(board->tail);
+    free(board->fenwick);
+    free(board->score);
+    free(board->next);
+    free(board->prev);
+    memset(board, 0, sizeof(Leaderboard));
+}
+
+void leaderboard_build(GameState* game) {
+    // Seed each difficulty with every player's best known score, then rank the totals once
+    for (int d = DIFFICULTY_EASY; d <= DIFFICULTY_HARD; d++) {
+        leaderboard_init(&game->leaderboards[d], MIN_QUIZ_SCORE, MAX_QUIZ_SCORE);
+    }
+    leaderboard_init(&game->leaderboards[LEADERBOARD_OVERALL], 3 * MIN_QUIZ_SCORE, 3 * MAX_QUIZ_SCORE);
+    
+    if (game->total_players == 0) {
+        return;
+    }
+    int* best = malloc((size_t)game->total_players * 3 * sizeof(int));
+    if (!best) {
+        printf("Failed to build leaderboards!\n");
+        return;
+    }
+    for (int i = 0; i < game->total_players; i++) {
+        for (int d = 0; d < 3; d++) {
+            best[i * 3 + d] = game->players[i].scores[d] != -1 ? game->players[i].scores[d] : INT_MIN;
+        }
+    }
+    const AttemptHistory* history = &game->attempts;
+    for (int i = 0; i < history->count; i++) {
+        int* slot = &best[history->player[i] * 3 + history->difficulty[i]];
+        if (history->score[i] > *slot) {
+            *slot = history->score[i];
+        }
+    }
+    
+    for (int i = 0; i < game->total_players; i++) {
+        bool ranked = false;
+        int total = 0;
+        for (int d = 0; d < 3; d++) {
+            if (best[i * 3 + d] != INT_MIN) {
+                leaderboard_set(&game->leaderboards[d], i, best[i * 3 + d]);
+                total += best[i * 3 + d];
+                ranked = true;
+            }
+        }
+        if (ranked) {
+            leaderboard_set(&game->leaderboards[LEADERBOARD_OVERALL], i, total);
+        }
+    }
+    free(best);
+}
+
+void leaderboard_submit(GameState* game, int player, int difficulty, int score) {
+    // Only a new best moves the player on this difficulty's board
+    Leaderboard* board = &game->leaderboards[difficulty];
+    if (leaderboard_rank(board, player) > 0 && board->score[player] >= score) {
+        return;
+    }
+    leaderboard_set(board, player, score);
+    
+    // Overall ranks the sum of the player's bests
+    int total = 0;
+    for (int d = DIFFICULTY_EASY; d <= DIFFICULTY_HARD; d++) {
+        if (leaderboard_rank(&game->leaderboards[d], player) > 0) {
+            total += game->leaderboards[d].score[player];
+        }
+    }
+    leaderboard_set(&game->leaderboards[LEADERBOARD_OVERALL], player, total);
+}
+
+void leaderboard_free(GameState* game) {
+    for (int i = 0; i < LEADERBOARD_COUNT; i++) {
+        leaderboard_destroy(&game->leaderboards[i]);
+    }
+}
+
+void add_default_questions(GameState* game) {
+    static const struct {
+        const char* question;
+        const char* options[MAX_OPTIONS];
+        int correct_option;
+        int difficulty;
+    } defaults[] = {
+        // Easy Questions (11 total)
+        {"What is 2 + 2?", {"3", "4", "5", "6"}, 1, DIFFICULTY_EASY},
+        {"What is the capital of France?", {"London", "Berlin", "Paris", "Madrid"}, 2, DIFFICULTY_EASY},
+        {"Which planet is closest to the sun?", {"Venus", "Mars", "Mercury", "Earth"}, 2, DIFFICULTY_EASY},
+        {"How many continents are there?", {"5", "6", "7", "8"}, 2, DIFFICULTY_EASY},
+        {"What is the largest ocean on Earth?", {"Atlantic", "Indian", "Arctic", "Pacific"}, 3, DIFFICULTY_EASY},
+        {"What color is a banana?", {"Red", "Green", "Yellow", "Blue"}, 2, DIFFICULTY_EASY},
+        {"How many days are in a week?", {"5", "6", "7", "8"}, 2, DIFFICULTY_EASY},
+        {"Which season comes after winter?", {"Summer", "Spring", "Fall", "Autumn"}, 1, DIFFICULTY_EASY},
+        {"What animal says 'moo'?", {"Sheep", "Cow", "Pig", "Horse"}, 1, DIFFICULTY_EASY},
+        {"What is 10 divided by 2?", {"5", "8", "12", "20"}, 0, DIFFICULTY_EASY},
+        {"What do bees make?", {"Silk", "Milk", "Honey", "Juice"}, 2, DIFFICULTY_EASY},
+
+        // Medium Questions (11 total)
+        {"What is the square root of 64?", {"4", "6", "8", "10"}, 2, DIFFICULTY_MEDIUM},
+        {"Which planet is known as the Red Planet?", {"Venus", "Mars", "Jupiter", "Saturn"}, 1, DIFFICULTY_MEDIUM},
+        {"What is the chemical symbol for water?", {"H2O", "CO2", "NaCl", "O2"}, 0, DIFFICULTY_MEDIUM},
+        {"Who wrote 'Romeo and Juliet'?", {"Charles Dickens", "William Shakespeare", "Jane Austen", "Mark Twain"}, 1, DIFFICULTY_MEDIUM},
+        {"What is the capital of Japan?", {"Beijing", "Seoul", "Tokyo", "Bangkok"}, 2, DIFFICULTY_MEDIUM},
+        {"What is the name of the longest river in Africa?", {"Amazon", "Nile", "Mississippi", "Yangtze"}, 1, DIFFICULTY_MEDIUM},
+        {"What is the boiling point of water in Celsius?", {"90°C", "100°C", "110°C", "212°C"}, 1, DIFFICULTY_MEDIUM},
+        {"Which musical instrument has 88 keys?", {"Guitar", "Violin", "Piano", "Flute"}, 2, DIFFICULTY_MEDIUM},
+        {"Which bone is the longest in the human body?", {"Femur", "Spine", "Tibia", "Humerus"}, 0, DIFFICULTY_MEDIUM},
+        {"How many sides does a hexagon have?", {"5", "6", "7", "8"}, 1, DIFFICULTY_MEDIUM},
+        {"What gas do plants absorb from the atmosphere?", {"Oxygen", "Nitrogen", "Carbon Dioxide", "Hydrogen"}, 2, DIFFICULTY_MEDIUM},
+
+        // Hard Questions (11 total)
+        {"What is the chemical symbol for Gold?", {"Go", "Gd", "Au", "Ag"}, 2, DIFFICULTY_HARD},
+        {"Who painted the Mona Lisa?", {"Vincent van Gogh", "Pablo Picasso", "Leonardo da Vinci", "Michelangelo"}, 2, DIFFICULTY_HARD},
+        {"What is the largest planet in our solar system?", {"Earth", "Saturn", "Jupiter", "Neptune"}, 2, DIFFICULTY_HARD},
+        {"Which element has the atomic number 1?", {"Helium", "Hydrogen", "Oxygen", "Carbon"}, 1, DIFFICULTY_HARD},
+        {"In which year did World War II end?", {"1943", "1945", "1947", "1950"}, 1, DIFFICULTY_HARD},
+        {"What is the smallest bone in the human body?", {"Stapes", "Femur", "Radius", "Patella"}, 0, DIFFICULTY_HARD},
+        {"Who was the first woman to win a Nobel Prize?", {"Marie Curie", "Rosalind Franklin", "Ada Lovelace", "Dorothy Hodgkin"}, 0, DIFFICULTY_HARD},
+        {"What is the capital of Australia?", {"Sydney", "Melbourne", "Canberra", "Perth"}, 2, DIFFICULTY_HARD},
+        {"In what year was the first iPhone released?", {"2005", "2007", "2009", "2010"}, 1, DIFFICULTY_HARD},
+        {"What is the speed of light in vacuum?", {"299,792 km/s", "300,000 km/s", "310,000 km/s", "250,000 km/s"}, 0, DIFFICULTY_HARD},
+        {"What is the chemical formula for sulfuric acid?", {"H2SO3", "H2SO4", "HNO3", "HCl"}, 1, DIFFICULTY_HARD}
+    };
+    
+    for (size_t i = 0; i < sizeof(defaults) / sizeof(defaults[0]); i++) {
+        Question question = {0};
+        question.question = string_pool_intern(&game->strings, defaults[i].question);
+        for (int j = 0; j < MAX_OPTIONS; j++) {
+            question.options[j] = string_pool_intern(&game->strings, defaults[i].options[j]);
+        }
+        question.correct_option = defaults[i].correct_option;
+        question.difficulty = defaults[i].difficulty;
+        question_bank_add(game, &question);
+    }
+}
+
+void put_le32(unsigned char* p, Uint32 value) {
+    p[0] = value & 0xFF;
+    p[1] = (value >> 8) & 0xFF;
+    p[2] = (value >> 16) & 0xFF;
+    p[3] = (value >> 24) & 0xFF;
+}
+
+Uint32 get_le32(const unsigned char* p) {
+    return (Uint32)p[0] | ((Uint32)p[1] << 8) | ((Uint32)p[2] << 16) | ((Uint32)p[3] << 24);
+}
+
+Uint32 fnv1a(Uint32 hash, const void* data, size_t size) {
+    // Start from FNV_OFFSET_BASIS, or from an earlier result to hash several ranges as one
+    const unsigned char* bytes = data;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+Uint32 checksum_bytes(const unsigned char* data, size_t size) {
+    return fnv1a(FNV_OFFSET_BASIS, data, size);
+}
+
+unsigned char* read_file(const char* path, size_t* size) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return NULL;
+    }
+    
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    unsigned char* data = length > 0 ? malloc(length) : NULL;
+    if (data && fread(data, 1, length, file) != (size_t)length) {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+    
+    *size = data ? (size_t)length : 0;
+    return data;
+}
+
+bool sync_file(FILE* file) {
+    // Push buffered data to the OS, then to the disk
+    if (fflush(file) != 0) {
+        return false;
+    }
+#ifndef _WIN32
+    return fsync(fileno(file)) == 0;
+#else
+    return true;
+#endif
+}
+
+bool copy_file(const char* from, const char* to) {
+    size_t size;
+    unsigned char* data = read_file(from, &size);
+    if (!data) {
+        return false;
+    }
+    
+    FILE* file = fopen(to, "wb");
+    bool written = file && fwrite(data, 1, size, file) == size;
+    if (file) {
+        written = sync_file(file) && written;
+        written = fclose(file) == 0 && written;
+    }
+    free(data);
+    if (!written) {
+        remove(to);
+    }
+    return written;
+}
+
+bool atomic_write_file(const char* path, const void* data, size_t size) {
+    // Write and sync a temp file beside the target, then rename it over the target so a
+    // crash or full disk leaves either the old file or the new one, never a partial one
+    char temp_path[256];
+    char backup_path[256];
+    snprintf(backup_path, sizeof(backup_path), "%s.bak", path);
+    
+    // The temp name is unique, so saves from other processes (a server, an import) never share it
+#ifndef _WIN32
+    snprintf(temp_path, sizeof(temp_path), "%s.XXXXXX", path);
+    FILE* file = NULL;
+    int fd = mkstemp(temp_path);
+    if (fd >= 0) {
+        // mkstemp makes the file private to its owner, the target keeps its own permissions
+        struct stat current;
+        fchmod(fd, stat(path, &current) == 0 ? (current.st_mode & 0777) : 0644);
+        file = fdopen(fd, "wb");
+        if (!file) {
+            close(fd);
+            remove(temp_path);
+        }
+    }
+#else
+    snprintf(temp_path, sizeof(temp_path), "%s.%d.tmp", path, _getpid());
+    FILE* file = fopen(temp_path, "wb");
+#endif
+    if (!file) {
+        printf("Failed to open a temp file for %s\n", path);
+        return false;
+    }
+    bool written = fwrite(data, 1, size, file) == size;
+    written = sync_file(file) && written;
+    written = fclose(file) == 0 && written;
+    if (!written) {
+        printf("Failed to write %s\n", temp_path);
+        remove(temp_path);
+        return false;
+    }
+    
+    // Keep the current file as the one-generation backup, a copy where hard links are not supported
+#ifndef _WIN32
+    remove(backup_path);
+    struct stat current;
+    if (link(path, backup_path) != 0 && stat(path, &current) == 0 && !copy_file(path, backup_path)) {
+        printf("Failed to back up %s\n", path);
+    }
+#else
+    remove(backup_path);
+    rename(path, backup_path);
+#endif
+    
+    if (rename(temp_path, path) != 0) {
+        printf("Failed to replace %s\n", path);
+        remove(temp_path);
+        return false;
+    }
+    
+#ifndef _WIN32
+    // Make the rename itself durable
+    int dir = open(".", O_RDONLY);
+    if (dir >= 0) {
+        fsync(dir);
+        close(dir);
+    }
+#endif
+    return true;
+}
+
+bool log_append_record(FILE* file, const unsigned char* payload, size_t payload_size) {
+    // Records are framed as payload size, payload checksum, payload, so a torn
+    // append at the end of a log is detected and dropped on replay. The caller
+    // syncs, which lets a run of appends share one sync.
+    unsigned char frame[8];
+    put_le32(frame, (Uint32)payload_size);
+    put_le32(frame + 4, checksum_bytes(payload, payload_size));
+    return fwrite(frame, 1, 8, file) == 8 && fwrite(payload, 1, payload_size, file) == payload_size;
+}
+
+const unsigned char* log_next_record(const unsigned char* data, size_t size, size_t* pos, size_t* payload_size) {
+    // Returns NULL at the end of the log or at the first damaged record, leaving pos there
+    if (size - *pos < 8) {
+        return NULL;
+    }
+    Uint32 length = get_le32(data + *pos);
+    const unsigned char* payload = data + *pos + 8;
+    if (length > size - *pos - 8 || checksum_bytes(payload, length) != get_le32(data + *pos + 4)) {
+        return NULL;
+    }
+    *pos += 8 + length;
+    *payload_size = length;
+    return payload;
+}
+
+bool io_start(void) {
+    // Until the worker runs, and if it cannot be started, jobs run on the calling thread
+    io_queue.ready = SDL_CreateSemaphore(0);
+    if (io_queue.ready) {
+        io_queue.thread = SDL_CreateThread(io_worker, "quiz-io", NULL);
+    }
+    if (!io_queue.thread) {
+        printf("Failed to start the I/O thread, saving on the main thread: %s\n", SDL_GetError());
+        if (io_queue.ready) {
+            SDL_DestroySemaphore(io_queue.ready);
+            io_queue.ready = NULL;
+        }
+        return false;
+    }
+    return true;
+}
+
+void io_submit(IoJob* job) {
+    if (!io_queue.thread) {
+        // Startup stages may do this on two threads at once, so only touch this job's log
+        io_run_job(job);
+        io_sync_log(job->log);
+        return;
+    }
+    
+    // A full ring means the disk is far behind, so wait for the worker to free a slot
+    int tail = SDL_AtomicGet(&io_queue.tail);
+    while (tail - SDL_AtomicGet(&io_queue.head) >= IO_QUEUE_SIZE) {
+        SDL_Delay(1);
+    }
+    io_queue.jobs[tail & (IO_QUEUE_SIZE - 1)] = *job;
+    SDL_AtomicSet(&io_queue.tail, tail + 1);
+    SDL_SemPost(io_queue.ready);
+}
+
+void io_save_file(const char* path, unsigned char* data, size_t size, int log, const unsigned char* header) {
+    // Takes ownership of data. With a header the log is reset once the file is
+    // replaced, without one it is reopened for appending.
+    IoJob job = {0};
+    job.type = IO_JOB_SAVE;
+    job.log = log;
+    job.path = path;
+    job.data = data;
+    job.size = size;
+    if (header) {
+        memcpy(job.header, header, sizeof(job.header));
+        job.has_header = true;
+    }
+    job.generation = SDL_AtomicAdd(&io_queue.save_generation[log], 1) + 1;
+    io_submit(&job);
+}
+
+void io_reset_log(int log, const unsigned char* header) {
+    IoJob job = {0};
+    job.type = IO_JOB_RESET_LOG;
+    job.log = log;
+    memcpy(job.header, header, sizeof(job.header));
+    job.has_header = true;
+    io_submit(&job);
+}
+
+void io_open_log(int log) {
+    IoJob job = {0};
+    job.type = IO_JOB_OPEN_LOG;
+    job.log = log;
+    io_submit(&job);
+}
+
+void io_append(int log, const unsigned char* payload, size_t payload_size) {
+    IoJob job = {0};
+    job.type = IO_JOB_APPEND;
+    job.log = log;
+    job.data = malloc(payload_size);
+    if (!job.data) {
+        printf("Failed to append to %s: out of memory\n", io_log_paths[log]);
+        return;
+    }
+    memcpy(job.data, payload, payload_size);
+    job.size = payload_size;
+    io_submit(&job);
+}
+
+bool io_log_failed(int log) {
+    return SDL_AtomicGet(&io_queue.log_failed[log]) != 0;
+}
+
+void io_shutdown(void) {
+    // Let the worker drain every queued job, then close the logs
+    if (io_queue.thread) {
+        IoJob quit = {0};
+        quit.type = IO_JOB_QUIT;
+        io_submit(&quit);
+        SDL_WaitThread(io_queue.thread, NULL);
+        SDL_DestroySemaphore(io_queue.ready);
+        io_queue.thread = NULL;
+        io_queue.ready = NULL;
+    }
+    io_sync_logs();
+    for (int i = 0; i < IO_LOG_COUNT; i++) {
+        if (io_queue.logs[i]) {
+            fclose(io_queue.logs[i]);
+            io_queue.logs[i] = NULL;
+        }
+    }
+}
+
+int io_worker(void* unused) {
+    (void)unused;
+    for (;;) {
+        // Sync once the ring runs dry, so a burst of appends shares one sync
+        if (SDL_AtomicGet(&io_queue.head) == SDL_AtomicGet(&io_queue.tail)) {
+            io_sync_logs();
+        }
+        SDL_SemWait(io_queue.ready);
+        
+        // Copy the job out before handing its slot back to the main thread
+        int head = SDL_AtomicGet(&io_queue.head);
+        IoJob job = io_queue.jobs[head & (IO_QUEUE_SIZE - 1)];
+        SDL_AtomicSet(&io_queue.head, head + 1);
+        if (job.type == IO_JOB_QUIT) {
+            break;
+        }
+        io_run_job(&job);
+    }
+    io_sync_logs();
+    return 0;
+}
+
+void io_run_job(IoJob* job) {
+    int log = job->log;
+    switch (job->type) {
+        case IO_JOB_SAVE:
+            // A newer save of this file is queued behind this one and covers everything
+            // it would write, so skip it. Its log is left alone too: that log still
+            // applies to the file on disk until the newer save replaces both.
+            if (job->generation != SDL_AtomicGet(&io_queue.save_generation[log])) {
+                break;
+            }
+            if (atomic_write_file(job->path, job->data, job->size)) {
+                io_reopen_log(log, job->has_header ? job->header : NULL);
+            } else if (job->has_header && !io_queue.logs[log]) {
+                // Keep appending to the old log, which still applies to the old file
+                io_reopen_log(log, NULL);
+            }
+            break;
+        case IO_JOB_RESET_LOG:
+            io_reopen_log(log, job->header);
+            break;
+        case IO_JOB_OPEN_LOG:
+            io_reopen_log(log, NULL);
+            break;
+        case IO_JOB_APPEND:
+            if (!io_queue.logs[log] || !log_append_record(io_queue.logs[log], job->data, job->size)) {
+                printf("Failed to append to %s\n", io_log_paths[log]);
+                SDL_AtomicSet(&io_queue.log_failed[log], 1);
+            } else {
+                io_queue.log_dirty[log] = true;
+            }
+            break;
+    }
+    free(job->data);
+}
+
+bool io_reopen_log(int log, const unsigned char* header) {
+    // With a header the log starts over, otherwise new records go after what is there
+    FILE** file = &io_queue.logs[log];
+    if (*file) {
+        if (io_queue.log_dirty[log]) {
+            sync_file(*file);
+        }
+        fclose(*file);
+    }
+    io_queue.log_dirty[log] = false;
+    
+    *file = fopen(io_log_paths[log], header ? "wb" : "ab");
+    bool opened = *file != NULL;
+    if (opened && header) {
+        opened = fwrite(header, 1, IO_LOG_HEADER_SIZE, *file) == IO_LOG_HEADER_SIZE && sync_file(*file);
+    }
+    if (!opened) {
+        printf("Failed to open %s\n", io_log_paths[log]);
+    }
+    SDL_AtomicSet(&io_queue.log_failed[log], !opened);
+    return opened;
+}
+
+void io_sync_log(int log) {
+    if (io_queue.log_dirty[log] && !sync_file(io_queue.logs[log])) {
+        printf("Failed to sync %s\n", io_log_paths[log]);
+        SDL_AtomicSet(&io_queue.log_failed[log], 1);
+    }
+    io_queue.log_dirty[log] = false;
+}
+
+void io_sync_logs(void) {
+    for (int i = 0; i < IO_LOG_COUNT; i++) {
+        io_sync_log(i);
+    }
+}
+
+bool pool_start(void) {
+    // One worker per core beside the SDL thread. With none, jobs run inline as they are submitted
+    int worker_count = SDL_GetCPUCount() - 1;
+    if (worker_count < 1) {
+        worker_count = 1;
+    }
+    if (worker_count > POOL_MAX_WORKERS) {
+        worker_count = POOL_MAX_WORKERS;
+    }
+    
+    thread_pool.worker_id = SDL_TLSCreate();
+    thread_pool.work = SDL_CreateSemaphore(0);
+    if (!thread_pool.worker_id || !thread_pool.work) {
+        printf("Failed to start thread pool: %s\n", SDL_GetError());
+        pool_shutdown();
+        return false;
+    }
+    
+    // Every deque exists before any worker starts looking for jobs to steal
+    for (int i = 0; i < worker_count; i++) {
+        PoolDeque* deque = &thread_pool.deques[i];
+        deque->lock = SDL_CreateMutex();
+        deque->jobs = malloc(POOL_INITIAL_DEQUE_CAPACITY * sizeof(PoolJob*));
+        deque->capacity = POOL_INITIAL_DEQUE_CAPACITY;
+        if (!deque->lock || !deque->jobs) {
+            SDL_DestroyMutex(deque->lock);
+            free(deque->jobs);
+            memset(deque, 0, sizeof(PoolDeque));
+            break;
+        }
+        thread_pool.worker_count++;
+    }
+    
+    // A deque whose thread failed to start is emptied by the others stealing from it
+    int started = 0;
+    for (int i = 0; i < thread_pool.worker_count; i++) {
+        thread_pool.threads[i] = SDL_CreateThread(pool_worker, "quiz-pool", (void*)(intptr_t)i);
+        if (thread_pool.threads[i]) {
+            started++;
+        }
+    }
+    if (started == 0) {
+        printf("Failed to start pool workers, jobs will run inline: %s\n", SDL_GetError());
+        pool_shutdown();
+        return false;
+    }
+    return true;
+}
+
+void pool_submit(void (*run)(void* data), void (*done)(void* data), void* data) {
+    // Queue a job. A worker pushes onto its own deque, anyone else spreads jobs round robin
+    PoolJob* job = malloc(sizeof(PoolJob));
+    if (!job) {
+        printf("Failed to allocate pool job, running it inline\n");
+        run(data);
+        if (done) {
+            done(data);
+        }
+        return;
+    }
+    job->run = run;
+    job->done = done;
+    job->data = data;
+    
+    if (thread_pool.worker_count == 0) {
+        pool_run(job);
+        return;
+    }
+    int worker = (int)(intptr_t)SDL_TLSGet(thread_pool.worker_id) - 1;
+    if (worker < 0) {
+        worker = (int)((unsigned)SDL_AtomicAdd(&thread_pool.next_deque, 1) % (unsigned)thread_pool.worker_count);
+    }
+    
+    PoolDeque* deque = &thread_pool.deques[worker];
+    SDL_LockMutex(deque->lock);
+    bool queued = pool_deque_push(deque, job);
+    SDL_UnlockMutex(deque->lock);
+    if (!queued) {
+        pool_run(job);
+        return;
+    }
+    SDL_SemPost(thread_pool.work);
+}
+
+void pool_complete(const SDL_Event* event) {
+    // SDL thread: a job finished, hand its results to whoever submitted it
+    PoolJob* job = event->user.data1;
+    job->done(job->data);
+    free(job);
+}
+
+void pool_shutdown(void) {
+    // Workers finish every queued job before they exit
+    SDL_AtomicSet(&thread_pool.quitting, 1);
+    for (int i = 0; i < thread_pool.worker_count; i++) {
+        SDL_SemPost(thread_pool.work);
+    }
+    for (int i = 0; i < thread_pool.worker_count; i++) {
+        if (thread_pool.threads[i]) {
+            SDL_WaitThread(thread_pool.threads[i], NULL);
+        }
+    }
+    
+    // Only once every worker has stopped, since any of them may steal from any deque
+    for (int i = 0; i < thread_pool.worker_count; i++) {
+        SDL_DestroyMutex(thread_pool.deques[i].lock);
+        free(thread_pool.deques[i].jobs);
+    }
+    if (thread_pool.work) {
+        SDL_DestroySemaphore(thread_pool.work);
+    }
+    memset(&thread_pool, 0, sizeof(ThreadPool));
+}
+
+int pool_worker(void* data) {
+    // Run jobs until the pool shuts down, sleeping only after finding none anywhere.
+    // Every queued job posts work once, so a job queued after the search still wakes someone
+    int worker = (int)(intptr_t)data;
+    SDL_TLSSet(thread_pool.worker_id, (void*)(intptr_t)(worker + 1), NULL);
+    for (;;) {
+        PoolJob* job = pool_take(worker);
+        if (job) {
+            pool_run(job);
+            continue;
+        }
+        if (SDL_AtomicGet(&thread_pool.quitting)) {
+            break;
+        }
+        SDL_SemWait(thread_pool.work);
+    }
+    return 0;
+}
+
+void pool_run(PoolJob* job) {
+    // Jobs with a done callback go back to the SDL thread, the rest are finished here
+    job->run(job->data);
+    if (!job->done) {
+        free(job);
+        return;
+    }
+    
+    SDL_Event event;
+    SDL_zero(event);
+    event.type = POOL_EVENT;
+    event.user.data1 = job;
+    if (SDL_PushEvent(&event) <= 0) {
+        printf("Failed to deliver pool job completion: %s\n", SDL_GetError());
+        free(job);
+    }
+}
+
+PoolJob* pool_take(int worker) {
+    // Newest job first: it was queued by the job just run, so its data is likely still in cache
+    PoolDeque* deque = &thread_pool.deques[worker];
+    PoolJob* job = NULL;
+    SDL_LockMutex(deque->lock);
+    if (deque->count > 0) {
+        deque->count--;
+        job = deque->jobs[(deque->head + deque->count) & (deque->capacity - 1)];
+    }
+    SDL_UnlockMutex(deque->lock);
+    return job ? job : pool_steal(worker);
+}
+
+PoolJob* pool_steal(int thief) {
+    // Take the oldest half of the first busy worker's deque: run one job and keep the rest,
+    // so a burst queued on one deque spreads across the pool in a few steals
+    for (int i = 1; i < thread_pool.worker_count; i++) {
+        int victim = (thief + i) % thread_pool.worker_count;
+        PoolDeque* from = &thread_pool.deques[victim];
+        PoolDeque* to = &thread_pool.deques[thief];
+        
+        // Deques are locked in index order so two workers stealing from each other cannot deadlock
+        SDL_mutex* first = victim < thief ? from->lock : to->lock;
+        SDL_mutex* second = victim < thief ? to->lock : from->lock;
+        SDL_LockMutex(first);
+        SDL_LockMutex(second);
+        PoolJob* job = NULL;
+        if (from->count > 0) {
+            int take = (from->count + 1) / 2;
+            job = from->jobs[from->head];
+            from->head = (from->head + 1) & (from->capacity - 1);
+            from->count--;
+            for (int j = 1; j < take && pool_deque_push(to, from->jobs[from->head]); j++) {
+                from->head = (from->head + 1) & (from->capacity - 1);
+                from->count--;
+            }
+        }
+        SDL_UnlockMutex(second);
+        SDL_UnlockMutex(first);
+        if (job) {
+            return job;
+        }
+    }
+    return NULL;
+}
+
+bool pool_deque_push(PoolDeque* deque, PoolJob* job) {
+    // Caller holds the deque's lock; a full ring doubles and is unrolled to start at 0
+    if (deque->count == deque->capacity) {
+        int new_capacity = deque->capacity * 2;
+        PoolJob** jobs = malloc(new_capacity * sizeof(PoolJob*));
+        if (!jobs) {
+            return false;
+        }
+        for (int i = 0; i < deque->count; i++) {
+            jobs[i] = deque->jobs[(deque->head + i) & (deque->capacity - 1)];
+        }
+        free(deque->jobs);
+        deque->jobs = jobs;
+        deque->capacity = new_capacity;
+        deque->head = 0;
+    }
+    deque->jobs[(deque->head + deque->count) & (deque->capacity - 1)] = job;
+    deque->count++;
+    return true;
+}
+
+void startup_begin(Startup* startup) {
+    // Without pool workers a stage runs here instead, its event arrives all the same
+    pool_submit(startup_load_font, NULL, startup);
+    pool_submit(startup_load_bank, NULL, startup);
+    pool_submit(startup_load_players, NULL, startup);
+}
+
+void startup_load_font(void* data) {
+    Startup* startup = data;
+    startup->font = open_font();
+    startup_finish(STARTUP_FONT);
+}
+
+void startup_load_bank(void* data) {
+    Startup* startup = data;
+    load_question_bank(startup->game, startup->map_bank);
+    startup_finish(STARTUP_BANK);
+}
+
+void startup_load_players(void* data) {
+    Startup* startup = data;
+    load_player_history(startup->game);
+    startup_finish(STARTUP_PLAYERS);
+}
+
+void load_question_bank(GameState* game, bool map_bank) {
+    // Load or create default questions
+    if (!map_bank || !map_questions(game)) {
+        load_questions(game);
+    }
+    if (game->total_questions == 0) {
+        add_default_questions(game);
+        save_questions(game);
+    }
+    journal_open(game);
+}
+
+void load_player_history(GameState* game) {
+    // Load player history, then rank it
+    load_players(game);
+    score_log_open(game);
+    attempt_history_open(game);
+    leaderboard_build(game);
+}
+
+void startup_finish(int stage) {
+    SDL_Event event;
+    SDL_zero(event);
+    event.type = STARTUP_EVENT;
+    event.user.code = stage;
+    SDL_PushEvent(&event);
+}
+
+bool startup_handle_event(Startup* startup, const SDL_Event* event) {
+    // The event queue's lock orders everything the stage wrote before its event is read here
+    if (event->type != STARTUP_EVENT) {
+        return false;
+    }
+    startup->done[event->user.code] = true;
+    return true;
+}
+
+bool startup_ready(const Startup* startup) {
+    for (int i = 0; i < STARTUP_STAGES; i++) {
+        if (!startup->done[i]) {
+            return false;
         }
     }
+    return true;
 }
 
-void show_player_history(SDL_Renderer* renderer, TTF_Font* font, GameState* game) {
+void render_startup_progress(SDL_Renderer* renderer, const Startup* startup) {
+    // A plain bar, since the font may not have loaded yet
     SDL_Color WHITE = {255, 255, 255, 255};
-    SDL_Color BLUE = {0, 0, 128, 255};
-    SDL_Color GREEN = {0, 255, 0, 255};
-    SDL_Color RED = {255, 0, 0, 255};
-    SDL_Color LIGHT_BLUE = {100, 149, 237, 255};
     
-    bool quit = false;
-    int start_index = 0;
-    int players_per_page = 5;
+    int done = 0;
+    for (int i = 0; i < STARTUP_STAGES; i++) {
+        done += startup->done[i];
+    }
+    SDL_Rect frame = {SCREEN_WIDTH/2 - 150, 560, 300, 20};
+    SDL_Rect bar = {frame.x, frame.y, frame.w * done / STARTUP_STAGES, frame.h};
+    SDL_SetRenderDrawColor(renderer, WHITE.r, WHITE.g, WHITE.b, WHITE.a);
+    SDL_RenderDrawRect(renderer, &frame);
+    SDL_RenderFillRect(renderer, &bar);
+}
+
+ImportBatch* import_batch_new(GameState* game, const char* path) {
+    ImportBatch* batch = calloc(1, sizeof(ImportBatch));
+    if (!batch) {
+        printf("Failed to allocate an import!\n");
+        return NULL;
+    }
+    batch->game = game;
+    snprintf(batch->path, sizeof(batch->path), "%s", path);
+    return batch;
+}
+
+void import_batch_free(ImportBatch* batch) {
+    string_pool_free(&batch->strings);
+    free(batch->questions);
+    free(batch);
+}
+
+void import_run(void* data) {
+    // Streams the file through one fixed buffer. Records are split and unescaped in place,
+    // and only text that passes validation is copied, into the batch's own pool.
+    ImportBatch* batch = data;
+    FILE* file = fopen(batch->path, "rb");
+    if (!file) {
+        snprintf(batch->error, sizeof(batch->error), "Cannot open the file");
+        batch->failed = true;
+        return;
+    }
+    fseek(file, 0, SEEK_END);
+    long total = ftell(file);
+    fseek(file, 0, SEEK_SET);
     
-    while (!quit) {
-        SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
-        SDL_RenderClear(renderer);
-        
-        // Title
-        render_text(renderer, font, "Player History", SCREEN_WIDTH/2 - 100, 50, WHITE);
-        
-        // Column headers
-        render_text(renderer, font, "Player", 50, 100, WHITE);
-        render_text(renderer, font, "Easy", 300, 100, WHITE);
-        render_text(renderer, font, "Medium", 400, 100, WHITE);
-        render_text(renderer, font, "Hard", 500, 100, WHITE);
-        
-        // Display players
-        for (int i = 0; i < players_per_page && (start_index + i) < game->total_players; i++) {
-            Player p = game->players[start_index + i];
-            
-            // Player name
-            render_text(renderer, font, p.name, 50, 150 + i * 50, WHITE);
-            
-            // Scores
-            char easy_score[10];
-            sprintf(easy_score, "%d", p.scores[DIFFICULTY_EASY]);
-            render_text(renderer, font, easy_score, 300, 150 + i * 50, 
-                       p.scores[DIFFICULTY_EASY] >= 0 ? GREEN : RED);
-            
-            char medium_score[10];
-            sprintf(medium_score, "%d", p.scores[DIFFICULTY_MEDIUM]);
-            render_text(renderer, font, medium_score, 400, 150 + i * 50, 
-                       p.scores[DIFFICULTY_MEDIUM] >= 0 ? GREEN : RED);
-            
-            char hard_score[10];
-            sprintf(hard_score, "%d", p.scores[DIFFICULTY_HARD]);
-            render_text(renderer, font, hard_score, 500, 150 + i * 50, 
-                       p.scores[DIFFICULTY_HARD] >= 0 ? GREEN : RED);
-        }
-        
-        // Navigation buttons
-        if (start_index > 0) {
-            render_button(renderer, font, "Previous", 50, 450, 150, 50, LIGHT_BLUE, WHITE);
+    // One spare byte, so the last field of a file without a final newline can be terminated
+    char* buffer = malloc(IMPORT_BUFFER_SIZE + 1);
+    if (!buffer) {
+        snprintf(batch->error, sizeof(batch->error), "Out of memory");
+        batch->failed = true;
+        fclose(file);
+        return;
+    }
+    
+    size_t filled = 0;
+    Sint64 read_total = 0;
+    bool at_end = false;
+    bool first = true;
+    while (!batch->failed) {
+        if (!at_end) {
+            size_t got = fread(buffer + filled, 1, IMPORT_BUFFER_SIZE - filled, file);
+            filled += got;
+            read_total += got;
+            if (ferror(file)) {
+                snprintf(batch->error, sizeof(batch->error), "Error reading the file");
+                batch->failed = true;
+                break;
+            }
+            at_end = filled < IMPORT_BUFFER_SIZE;
+            if (total > 0) {
+                SDL_AtomicSet(&batch->progress, (int)(read_total * 100 / total));
+            }
         }
         
-        if (start_index + players_per_page < game->total_players) {
-            render_button(renderer, font, "Next", SCREEN_WIDTH - 200, 450, 150, 50, LIGHT_BLUE, WHITE);
+        // Skip a UTF-8 byte order mark, then pick the format from the name or a leading '{'
+        size_t pos = 0;
+        if (first) {
+            first = false;
+            if (filled >= 3 && memcmp(buffer, "\xEF\xBB\xBF", 3) == 0) {
+                pos = 3;
+            }
+            const char* extension = strrchr(batch->path, '.');
+            size_t start = pos;
+            while (start < filled && (buffer[start] == ' ' || buffer[start] == '\t' || buffer[start] == '\r' || buffer[start] == '\n')) {
+                start++;
+            }
+            batch->json = (extension && (SDL_strcasecmp(extension, ".jsonl") == 0 || SDL_strcasecmp(extension, ".json") == 0)) ||
+                          (start < filled && buffer[start] == '{');
         }
         
-        // Back button
-        render_button(renderer, font, "Back", SCREEN_WIDTH/2 - 75, 520, 150, 50, GREEN, WHITE);
-        
-        SDL_RenderPresent(renderer);
-        
-        SDL_Event event;
-        while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_QUIT) {
-                quit = true;
-            }
-            
-            if (event.type == SDL_MOUSEBUTTONDOWN) {
-                int mouse_x, mouse_y;
-                SDL_GetMouseState(&mouse_x, &mouse_y);
-                
-                // Previous button
-                if (start_index > 0 && is_button_clicked(mouse_x, mouse_y, 50, 450, 150, 50)) {
-                    start_index -= players_per_page;
-                    if (start_index < 0) start_index = 0;
-                }
-                
-                // Next button
-                if (start_index + players_per_page < game->total_players && 
-                    is_button_clicked(mouse_x, mouse_y, SCREEN_WIDTH - 200, 450, 150, 50)) {
-                    start_index += players_per_page;
+        while (pos < filled && !batch->failed) {
+            size_t used;
+            if (batch->json) {
+                char* newline = memchr(buffer + pos, '\n', filled - pos);
+                if (!newline && !at_end) {
+                    break;
                 }
-                
-                // Back button
-                if (is_button_clicked(mouse_x, mouse_y, SCREEN_WIDTH/2 - 75, 520, 150, 50)) {
-                    quit = true;
+                char* end = newline ? newline : buffer + filled;
+                *end = '\0';
+                used = end - (buffer + pos) + (newline != NULL);
+                import_json_line(batch, buffer + pos);
+            } else {
+                char* fields[IMPORT_MAX_FIELDS];
+                int field_count = 0;
+                int result = import_csv_record(buffer + pos, filled - pos, at_end, &used, fields, &field_count);
+                if (result == 0) {
+                    break;
                 }
+                import_csv_fields(batch, result > 0 ? fields : NULL, field_count);
             }
+            pos += used;
+        }
+        
+        // Carry the partial record to the front, the next read completes it
+        filled -= pos;
+        memmove(buffer, buffer + pos, filled);
+        if (at_end) {
+            break;
+        }
+        if (filled == IMPORT_BUFFER_SIZE) {
+            snprintf(batch->error, sizeof(batch->error), "Record %d is longer than %d bytes", batch->records + 1, IMPORT_BUFFER_SIZE);
+            batch->failed = true;
         }
     }
+    
+    free(buffer);
+    fclose(file);
 }
 
-void add_player_score(GameState* game, const char* name, int difficulty, int score) {
-    // Check if player already exists
-    int player_index = -1;
-    for (int i = 0; i < game->total_players; i++) {
-        if (strcmp(game->players[i].name, name) == 0) {
-            player_index = i;
-            break;
+int import_csv_record(char* data, size_t size, bool at_end, size_t* used, char** fields, int* field_count) {
+    // Splits one record off the front of data, RFC 4180 style: quoted fields may hold commas,
+    // line breaks and "" for a quote. Fields are unquoted and NUL-terminated in place, so data
+    // needs room for one byte more. Returns 1 for a record, -1 for a malformed one (still
+    // consumed), 0 when data ends before the record does and more must be read first.
+    char* end = data + size;
+    
+    // Find where the record ends before rewriting anything, it may not all be here yet
+    char* line_end = memchr(data, '\n', size);
+    if (!line_end) {
+        line_end = end;
+    }
+    if (memchr(data, '"', line_end - data)) {
+        bool quoted = false;
+        for (line_end = data; line_end < end && (quoted || *line_end != '\n'); line_end++) {
+            quoted ^= *line_end == '"';
         }
     }
+    if (line_end == end && !at_end) {
+        return 0;
+    }
+    *used = line_end - data + (line_end < end);
+    if (line_end > data && line_end[-1] == '\r') {
+        line_end--;
+    }
+    *line_end = '\0';
     
-    if (player_index != -1) {
-        // Update existing player's score for this difficulty
-        game->players[player_index].scores[difficulty] = score;
-    } else if (game->total_players < MAX_PLAYERS) {
-        // Add new player
-        strcpy(game->players[game->total_players].name, name);
-        // Initialize all scores to -1 (not attempted)
-        for (int i = 0; i < 3; i++) {
-            game->players[game->total_players].scores[i] = -1;
+    char* p = data;
+    int count = 0;
+    while (true) {
+        char* field = p;
+        char* field_end;
+        if (*p == '"') {
+            // Copy the text down over the quotes
+            char* out = p++;
+            while (true) {
+                char* quote = memchr(p, '"', line_end - p);
+                if (!quote) {
+                    return -1;
+                }
+                memmove(out, p, quote - p);
+                out += quote - p;
+                p = quote + 1;
+                if (*p != '"') {
+                    break;
+                }
+                *out++ = '"';
+                p++;
+            }
+            field_end = out;
+            if (*p != ',' && *p != '\0') {
+                return -1;
+            }
+        } else {
+            while (*p != ',' && *p != '\0') {
+                p++;
+            }
+            field_end = p;
         }
-        // Set the current difficulty score
-        game->players[game->total_players].scores[difficulty] = score;
-        game->total_players++;
+        
+        char delimiter = *p;
+        *field_end = '\0';
+        if (count < IMPORT_MAX_FIELDS) {
+            fields[count] = field;
+        }
+        count++;
+        if (delimiter == '\0') {
+            break;
+        }
+        p++;
     }
-    
-    // Save the updated player data
-    save_players(game);
+    *field_count = count;
+    return 1;
 }
 
-void add_questions(SDL_Renderer* renderer, TTF_Font* font, GameState* game) {
-    SDL_Color WHITE = {255, 255, 255, 255};
-    SDL_Color BLUE = {0, 0, 128, 255};
-    SDL_Color LIGHT_BLUE = {100, 149, 237, 255};
-    SDL_Color GREEN = {0, 255, 0, 255};
-    SDL_Color RED = {255, 0, 0, 255};
-    
-    // Check if question limit is reached
-    if (game->total_questions >= MAX_QUESTIONS) {
-        SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
-        SDL_RenderClear(renderer);
-        render_text(renderer, font, "Question limit reached!", SCREEN_WIDTH/2 - 150, 250, RED);
-        SDL_RenderPresent(renderer);
-        SDL_Delay(1500);
+void import_csv_fields(ImportBatch* batch, char** fields, int field_count) {
+    // Columns: question, four options, correct option, then an optional difficulty.
+    // Blank lines and a header row naming the first column are skipped.
+    if (fields && field_count == 1 && fields[0][0] == '\0') {
+        return;
+    }
+    if (fields && batch->records == 0 && !batch->header_checked && SDL_strcasecmp(fields[0], "question") == 0) {
+        batch->header_checked = true;
         return;
     }
+    batch->header_checked = true;
+    batch->records++;
     
-    Question new_question = {0};
+    if (!fields) {
+        import_reject(batch, "unbalanced quotes");
+    } else if (field_count < 2 + MAX_OPTIONS || field_count > 3 + MAX_OPTIONS) {
+        import_reject(batch, "expected 6 or 7 columns");
+    } else {
+        const char* difficulty = field_count > 2 + MAX_OPTIONS ? fields[2 + MAX_OPTIONS] : "";
+        import_add(batch, fields[0], fields + 1, import_parse_correct(fields[1 + MAX_OPTIONS]), import_parse_difficulty(difficulty));
+    }
+}
+
+void import_json_line(ImportBatch* batch, char* line) {
+    // One object per line: {"question": "...", "options": ["...", ...], "correct": 1, "difficulty": "easy"}.
+    // Strings are unescaped in place, keys other than these are skipped.
+    char* p = json_skip_space(line);
+    if (*p == '\0') {
+        return;
+    }
+    batch->records++;
     
-    // Select Difficulty
-    bool difficulty_selected = false;
-    while (!difficulty_selected) {
-        SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
-        SDL_RenderClear(renderer);
-        
-        render_text(renderer, font, "Select Difficulty", SCREEN_WIDTH/2 - 100, 100, WHITE);
-        
-        render_button(renderer, font, "Easy", SCREEN_WIDTH/2 - 100, 200, 200, 50, LIGHT_BLUE, WHITE);
-        render_button(renderer, font, "Medium", SCREEN_WIDTH/2 - 100, 300, 200, 50, LIGHT_BLUE, WHITE);
-        render_button(renderer, font, "Hard", SCREEN_WIDTH/2 - 100, 400, 200, 50, LIGHT_BLUE, WHITE);
-        
-        SDL_RenderPresent(renderer);
+    char* question = NULL;
+    char* options[MAX_OPTIONS] = {NULL};
+    int correct = -1;
+    int difficulty = IMPORT_ASSIGN_DIFFICULTY;
+    if (*p != '{') {
+        import_reject(batch, "not a JSON object");
+        return;
+    }
+    p = json_skip_space(p + 1);
+    while (*p != '}') {
+        char* key;
+        if (*p != '"' || !(p = json_string(p, &key))) {
+            import_reject(batch, "malformed key");
+            return;
+        }
+        p = json_skip_space(p);
+        if (*p != ':') {
+            import_reject(batch, "expected ':' after a key");
+            return;
+        }
+        p = json_skip_space(p + 1);
         
-        SDL_Event event;
-        while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_QUIT) {
+        char* text = NULL;
+        if (strcmp(key, "options") == 0) {
+            if (*p != '[') {
+                import_reject(batch, "options must be an array");
                 return;
             }
-            
-            if (event.type == SDL_MOUSEBUTTONDOWN) {
-                int mouse_x, mouse_y;
-                SDL_GetMouseState(&mouse_x, &mouse_y);
-                
-                if (is_button_clicked(mouse_x, mouse_y, SCREEN_WIDTH/2 - 100, 200, 200, 50)) {
-                    new_question.difficulty = DIFFICULTY_EASY;
-                    difficulty_selected = true;
-                }
-                if (is_button_clicked(mouse_x, mouse_y, SCREEN_WIDTH/2 - 100, 300, 200, 50)) {
-                    new_question.difficulty = DIFFICULTY_MEDIUM;
-                    difficulty_selected = true;
+            int count = 0;
+            p = json_skip_space(p + 1);
+            while (*p != ']') {
+                if (*p != '"' || !(p = json_string(p, &text)) || count == MAX_OPTIONS) {
+                    import_reject(batch, "options must be 4 strings");
+                    return;
                 }
-                if (is_button_clicked(mouse_x, mouse_y, SCREEN_WIDTH/2 - 100, 400, 200, 50)) {
-                    new_question.difficulty = DIFFICULTY_HARD;
-                    difficulty_selected = true;
+                options[count++] = text;
+                p = json_skip_space(p);
+                if (*p == ',') {
+                    p = json_skip_space(p + 1);
+                } else if (*p != ']') {
+                    import_reject(batch, "malformed options array");
+                    return;
                 }
             }
+            if (count < MAX_OPTIONS) {
+                import_reject(batch, "options must be 4 strings");
+                return;
+            }
+            p++;
+        } else if (strcmp(key, "correct") == 0 && *p != '"') {
+            char* after;
+            long value = strtol(p, &after, 10);
+            correct = after > p && value >= 1 && value <= MAX_OPTIONS ? (int)value - 1 : -1;
+            p = after;
+        } else if (strcmp(key, "question") == 0 || strcmp(key, "correct") == 0 || strcmp(key, "difficulty") == 0) {
+            if (*p != '"' || !(p = json_string(p, &text))) {
+                import_reject(batch, "expected a string");
+                return;
+            }
+            if (key[0] == 'q') {
+                question = text;
+            } else if (key[0] == 'c') {
+                correct = import_parse_correct(text);
+            } else {
+                difficulty = import_parse_difficulty(text);
+            }
+        } else if (!(p = json_skip_value(p))) {
+            import_reject(batch, "malformed value");
+            return;
         }
-    }
-    
-    // Enter Question
-    SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
-    SDL_RenderClear(renderer);
-    render_text(renderer, font, "Enter Question", SCREEN_WIDTH/2 - 100, 100, WHITE);
-    SDL_RenderPresent(renderer);
-    
-    char question_input[MAX_QUESTION_LENGTH];
-    get_text_input(renderer, font, question_input, MAX_QUESTION_LENGTH, "Enter the question:");
-    strcpy(new_question.question, question_input);
-    
-    // Enter Options
-    for (int i = 0; i < MAX_OPTIONS; i++) {
-        SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
-        SDL_RenderClear(renderer);
         
-        char option_prompt[100];
-        sprintf(option_prompt, "Enter Option %d", i + 1);
-        render_text(renderer, font, option_prompt, SCREEN_WIDTH/2 - 100, 100, WHITE);
-        SDL_RenderPresent(renderer);
-        
-        char option_input[MAX_OPTION_LENGTH];
-        get_text_input(renderer, font, option_input, MAX_OPTION_LENGTH, option_prompt);
-        strcpy(new_question.options[i], option_input);
+        p = json_skip_space(p);
+        if (*p == ',') {
+            p = json_skip_space(p + 1);
+        } else if (*p != '}') {
+            import_reject(batch, "expected ',' or '}'");
+            return;
+        }
     }
     
-    // Select Correct Option
-    bool correct_selected = false;
-    while (!correct_selected) {
-        SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
-        SDL_RenderClear(renderer);
-        
-        render_text(renderer, font, "Select Correct Option", SCREEN_WIDTH/2 - 100, 100, WHITE);
-        
-        for (int i = 0; i < MAX_OPTIONS; i++) {
-            char button_text[MAX_OPTION_LENGTH + 10];
-            sprintf(button_text, "%d. %s", i + 1, new_question.options[i]);
-            render_button(renderer, font, button_text, SCREEN_WIDTH/2 - 100, 200 + i * 80, 200, 50, LIGHT_BLUE, WHITE);
+    if (!question || !options[0]) {
+        import_reject(batch, "question or options missing");
+        return;
+    }
+    import_add(batch, question, options, correct, difficulty);
+}
+
+char* json_skip_space(char* p) {
+    while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') {
+        p++;
+    }
+    return p;
+}
+
+char* json_string(char* p, char** text) {
+    // p is at the opening quote. Unescaped text is never longer than its escaped form, so it is
+    // written over it and NUL-terminated at most on the closing quote. Returns the character
+    // after the closing quote, NULL if the string is malformed.
+    char* out = ++p;
+    *text = out;
+    while (*p != '"') {
+        if (*p == '\0') {
+            return NULL;
         }
-        
-        SDL_RenderPresent(renderer);
-        
-        SDL_Event event;
-        while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_QUIT) {
-                return;
-            }
-            
-            if (event.type == SDL_MOUSEBUTTONDOWN) {
-                int mouse_x, mouse_y;
-                SDL_GetMouseState(&mouse_x, &mouse_y);
+        if (*p != '\\') {
+            *out++ = *p++;
+            continue;
+        }
+        p++;
+        switch (*p++) {
+            case '"': *out++ = '"'; break;
+            case '\\': *out++ = '\\'; break;
+            case '/': *out++ = '/'; break;
+            case 'b': *out++ = '\b'; break;
+            case 'f': *out++ = '\f'; break;
+            case 'n': *out++ = '\n'; break;
+            case 'r': *out++ = '\r'; break;
+            case 't': *out++ = '\t'; break;
+            case 'u': {
+                Uint32 code = json_hex4(p);
+                if (code > 0xFFFF) {
+                    return NULL;
+                }
+                p += 4;
                 
-                for (int i = 0; i < MAX_OPTIONS; i++) {
-                    if (is_button_clicked(mouse_x, mouse_y, SCREEN_WIDTH/2 - 100, 200 + i * 80, 200, 50)) {
-                        new_question.correct_option = i;
-                        correct_selected = true;
-                        break;
+                // A surrogate pair encodes one character outside the basic plane, a lone half becomes U+FFFD
+                if (code >= 0xD800 && code < 0xDC00 && p[0] == '\\' && p[1] == 'u') {
+                    Uint32 low = json_hex4(p + 2);
+                    if (low >= 0xDC00 && low < 0xE000) {
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                        p += 6;
                     }
                 }
+                if (code >= 0xD800 && code < 0xE000) {
+                    code = 0xFFFD;
+                }
+                
+                if (code < 0x80) {
+                    *out++ = (char)code;
+                } else if (code < 0x800) {
+                    *out++ = (char)(0xC0 | (code >> 6));
+                    *out++ = (char)(0x80 | (code & 0x3F));
+                } else if (code < 0x10000) {
+                    *out++ = (char)(0xE0 | (code >> 12));
+                    *out++ = (char)(0x80 | ((code >> 6) & 0x3F));
+                    *out++ = (char)(0x80 | (code & 0x3F));
+                } else {
+                    *out++ = (char)(0xF0 | (code >> 18));
+                    *out++ = (char)(0x80 | ((code >> 12) & 0x3F));
+                    *out++ = (char)(0x80 | ((code >> 6) & 0x3F));
+                    *out++ = (char)(0x80 | (code & 0x3F));
+                }
+                break;
+            }
+            default:
+                return NULL;
+        }
+    }
+    *out = '\0';
+    return p + 1;
+}
+
+Uint32 json_hex4(const char* p) {
+    // Value of four hex digits, above 0xFFFF if they are not all there
+    Uint32 value = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = p[i];
+        if (c >= '0' && c <= '9') {
+            value = value * 16 + (c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            value = value * 16 + (c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            value = value * 16 + (c - 'A' + 10);
+        } else {
+            return 0x10000;
+        }
+    }
+    return value;
+}
+
+char* json_skip_value(char* p) {
+    // Skips a value the import has no use for, nested arrays and objects included
+    if (*p == '"') {
+        char* text;
+        return json_string(p, &text);
+    }
+    if (*p != '{' && *p != '[') {
+        // A number, true, false or null runs up to the next delimiter
+        while (*p != '\0' && *p != ',' && *p != '}' && *p != ']') {
+            p++;
+        }
+        return p;
+    }
+    
+    int depth = 0;
+    do {
+        if (*p == '"') {
+            char* text;
+            if (!(p = json_string(p, &text))) {
+                return NULL;
             }
+            continue;
+        }
+        if (*p == '\0') {
+            return NULL;
+        }
+        if (*p == '{' || *p == '[') {
+            depth++;
+        } else if (*p == '}' || *p == ']') {
+            depth--;
+        }
+        p++;
+    } while (depth > 0);
+    return p;
+}
+
+int import_parse_correct(const char* text) {
+    // The correct option by number, 1-4, or letter, A-D; -1 if it is neither
+    char c = text[0];
+    if (c == '\0' || text[1] != '\0') {
+        return -1;
+    }
+    if (c >= '1' && c < '1' + MAX_OPTIONS) {
+        return c - '1';
+    }
+    if (c >= 'A' && c < 'A' + MAX_OPTIONS) {
+        return c - 'A';
+    }
+    if (c >= 'a' && c < 'a' + MAX_OPTIONS) {
+        return c - 'a';
+    }
+    return -1;
+}
+
+int import_parse_difficulty(const char* text) {
+    static const char* names[3] = {"easy", "medium", "hard"};
+    if (text[0] == '\0') {
+        return IMPORT_ASSIGN_DIFFICULTY;
+    }
+    for (int d = DIFFICULTY_EASY; d <= DIFFICULTY_HARD; d++) {
+        if (SDL_strcasecmp(text, names[d]) == 0) {
+            return d;
         }
     }
+    return IMPORT_BAD_DIFFICULTY;
+}
+
+void import_reject(ImportBatch* batch, const char* reason) {
+    // The first few are printed, the summary only counts the rest
+    batch->rejected++;
+    if (batch->rejected <= IMPORT_REPORTED_ERRORS) {
+        printf("%s: record %d skipped: %s\n", batch->path, batch->records, reason);
+    }
+    if (batch->rejected == 1) {
+        snprintf(batch->error, sizeof(batch->error), "Record %d: %s", batch->records, reason);
+    }
+}
+
+void import_add(ImportBatch* batch, char* question, char** options, int correct, int difficulty) {
+    if (correct < 0) {
+        import_reject(batch, "correct option must be 1-4 or A-D");
+        return;
+    }
+    if (difficulty == IMPORT_BAD_DIFFICULTY) {
+        import_reject(batch, "difficulty must be easy, medium or hard");
+        return;
+    }
     
-    // Add question to game
-    game->questions[game->total_questions++] = new_question;
+    // Text must fit the fixed-size fields of the older bank format and the edit screens.
+    // Line breaks and tabs from quoted text would break the one-line layout, they become spaces.
+    for (int i = 0; i <= MAX_OPTIONS; i++) {
+        char* text = i == 0 ? question : options[i - 1];
+        size_t length = strlen(text);
+        if (length == 0) {
+            import_reject(batch, i == 0 ? "question is empty" : "an option is empty");
+            return;
+        }
+        if (length >= (size_t)(i == 0 ? MAX_QUESTION_LENGTH : MAX_OPTION_LENGTH)) {
+            import_reject(batch, i == 0 ? "question is too long" : "an option is too long");
+            return;
+        }
+        for (char* c = text; *c; c++) {
+            if ((unsigned char)*c < ' ') {
+                *c = ' ';
+            }
+        }
+    }
     
-    // Save questions
-    save_questions(game);
+    if (batch->count == batch->capacity) {
+        int capacity = batch->capacity ? batch->capacity * 2 : INITIAL_QUESTION_CAPACITY;
+        Question* questions = realloc(batch->questions, capacity * sizeof(Question));
+        if (!questions) {
+            snprintf(batch->error, sizeof(batch->error), "Out of memory at record %d", batch->records);
+            batch->failed = true;
+            return;
+        }
+        batch->questions = questions;
+        batch->capacity = capacity;
+    }
     
-    // Confirmation
-    SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
-    SDL_RenderClear(renderer);
-    render_text(renderer, font, "Question Added Successfully!", SCREEN_WIDTH/2 - 150, 250, GREEN);
-    SDL_RenderPresent(renderer);
-    SDL_Delay(1500);
+    // Interning is non-empty text only, so 0 means the pool could not grow
+    Question* staged = &batch->questions[batch->count];
+    staged->question = string_pool_intern(&batch->strings, question);
+    bool interned = staged->question != 0;
+    for (int i = 0; i < MAX_OPTIONS && interned; i++) {
+        staged->options[i] = string_pool_intern(&batch->strings, options[i]);
+        interned = staged->options[i] != 0;
+    }
+    if (!interned) {
+        snprintf(batch->error, sizeof(batch->error), "Out of memory at record %d", batch->records);
+        batch->failed = true;
+        return;
+    }
+    staged->correct_option = correct;
+    staged->difficulty = difficulty;
+    batch->count++;
 }
 
-void view_questions(SDL_Renderer* renderer, TTF_Font* font, GameState* game) {
-    SDL_Color WHITE = {255, 255, 255, 255};
-    SDL_Color BLUE = {0, 0, 128, 255};
-    SDL_Color LIGHT_BLUE = {100, 149, 237, 255};
-    SDL_Color GREEN = {0, 255, 0, 255};
-    SDL_Color RED = {255, 0, 0, 255};
+void import_merge(ImportBatch* batch) {
+    // Appends the parsed questions to the bank, skipping any whose text it already has, and
+    // saves the bank once for the lot. Nothing is added from a file that could not be read through.
+    GameState* game = batch->game;
+    if (batch->failed || batch->count == 0) {
+        return;
+    }
+    if (!question_bank_make_writable(game) || !question_bank_reserve(game, game->total_questions + batch->count)) {
+        snprintf(batch->error, sizeof(batch->error), "Out of memory adding %d questions", batch->count);
+        batch->failed = true;
+        return;
+    }
+    
+    // Interned text is shared, so a known question interns to an offset marked here, a bit per pool byte
+    size_t seen_size = (game->strings.base_size + game->strings.used) / 8 + 1;
+    Uint8* seen = calloc(seen_size, 1);
+    if (!seen) {
+        snprintf(batch->error, sizeof(batch->error), "Out of memory adding %d questions", batch->count);
+        batch->failed = true;
+        return;
+    }
+    for (int i = 0; i < game->total_questions; i++) {
+        Uint32 offset = get_question(game, i)->question;
+        if (offset / 8 < seen_size) {
+            seen[offset / 8] |= 1 << (offset % 8);
+        }
+    }
     
-    int current_index = 0;
-    bool quit = false;
-    SDL_Event event;
+    // Questions without a difficulty go to whichever level has fewest at the time
+    int counts[3];
+    for (int d = DIFFICULTY_EASY; d <= DIFFICULTY_HARD; d++) {
+        counts[d] = count_questions_by_difficulty(game, d);
+    }
     
-    while (!quit && current_index < game->total_questions) {
-        SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
-        SDL_RenderClear(renderer);
-        
-        // Display question number
-        char question_num[50];
-        sprintf(question_num, "Question %d/%d", current_index + 1, game->total_questions);
-        render_text(renderer, font, question_num, SCREEN_WIDTH/2 - 100, 50, WHITE);
-        
-        // Display difficulty
-        const char* difficulty_str;
-        switch (game->questions[current_index].difficulty) {
-            case DIFFICULTY_EASY: difficulty_str = "Easy"; break;
-            case DIFFICULTY_MEDIUM: difficulty_str = "Medium"; break;
-            case DIFFICULTY_HARD: difficulty_str = "Hard"; break;
-            default: difficulty_str = "Unknown";
+    for (int i = 0; i < batch->count; i++) {
+        const Question* staged = &batch->questions[i];
+        Question question = *staged;
+        question.question = string_pool_intern(&game->strings, string_pool_get(&batch->strings, staged->question));
+        for (int j = 0; j < MAX_OPTIONS && question.question; j++) {
+            question.options[j] = string_pool_intern(&game->strings, string_pool_get(&batch->strings, staged->options[j]));
+            if (!question.options[j]) {
+                question.question = 0;
+            }
         }
-        render_text(renderer, font, difficulty_str, SCREEN_WIDTH - 150, 50, WHITE);
-        
-        // Display question
-        render_text(renderer, font, game->questions[current_index].question, 50, 100, WHITE);
-        
-        // Display options
-        for (int i = 0; i < MAX_OPTIONS; i++) {
-            char option_text[150];
-            sprintf(option_text, "%d. %s", i + 1, game->questions[current_index].options[i]);
-            render_text(renderer, font, option_text, 100, 200 + i * 50, WHITE);
+        if (!question.question) {
+            snprintf(batch->error, sizeof(batch->error), "Out of memory after %d questions", batch->added);
+            batch->failed = true;
+            break;
         }
         
-        // Highlight correct answer
-        char correct_text[100];
-        sprintf(correct_text, "Correct Answer: %d", game->questions[current_index].correct_option + 1);
-        render_text(renderer, font, correct_text, 50, 400, GREEN);
-        
-        // Navigation buttons
-        if (current_index > 0) {
-            render_button(renderer, font, "Previous", 50, 500, 150, 50, LIGHT_BLUE, WHITE);
+        if (question.question / 8 >= seen_size) {
+            size_t grown = seen_size * 2 > question.question / 8 + 1 ? seen_size * 2 : question.question / 8 + 1;
+            Uint8* bits = realloc(seen, grown);
+            if (!bits) {
+                snprintf(batch->error, sizeof(batch->error), "Out of memory after %d questions", batch->added);
+                batch->failed = true;
+                break;
+            }
+            memset(bits + seen_size, 0, grown - seen_size);
+            seen = bits;
+            seen_size = grown;
         }
-        if (current_index < game->total_questions - 1) {
-            render_button(renderer, font, "Next", SCREEN_WIDTH - 200, 500, 150, 50, LIGHT_BLUE, WHITE);
+        if (seen[question.question / 8] & (1 << (question.question % 8))) {
+            batch->duplicates++;
+            continue;
         }
+        seen[question.question / 8] |= 1 << (question.question % 8);
         
-        // Edit and Delete buttons
-        render_button(renderer, font, "Edit", SCREEN_WIDTH/2 - 75, 500, 150, 50, LIGHT_BLUE, WHITE);
-        render_button(renderer, font, "Delete", SCREEN_WIDTH/2 - 75, 570, 150, 50, RED, WHITE);
-        
-        // Back button
-        render_button(renderer, font, "Back", SCREEN_WIDTH/2 - 75, 640, 150, 50, LIGHT_BLUE, WHITE);
-        
-        SDL_RenderPresent(renderer);
-        
-        while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_QUIT) {
-                quit = true;
-                break;
-            }
-            
-            if (event.type == SDL_MOUSEBUTTONDOWN) {
-                int mouse_x, mouse_y;
-                SDL_GetMouseState(&mouse_x, &mouse_y);
-                
-                // Previous button
-                if (current_index > 0 && is_button_clicked(mouse_x, mouse_y, 50, 500, 150, 50)) {
-                    current_index--;
-                }
-                
-                // Next button
-                if (current_index < game->total_questions - 1 && is_button_clicked(mouse_x, mouse_y, SCREEN_WIDTH - 200, 500, 150, 50)) {
-                    current_index++;
-                }
-                
-                // Edit button
-                if (is_button_clicked(mouse_x, mouse_y, SCREEN_WIDTH/2 - 75, 500, 150, 50)) {
-                    edit_question(renderer, font, game, current_index);
-                }
-                
-                // Delete button
-                if (is_button_clicked(mouse_x, mouse_y, SCREEN_WIDTH/2 - 75, 570, 150, 50)) {
-                    delete_question(renderer, font, game, current_index);
-                    if (current_index >= game->total_questions) {
-                        current_index = game->total_questions - 1;
-                    }
-                }
-                
-                // Back button
-                if (is_button_clicked(mouse_x, mouse_y, SCREEN_WIDTH/2 - 75, 640, 150, 50)) {
-                    quit = true;
+        if (question.difficulty == IMPORT_ASSIGN_DIFFICULTY) {
+            question.difficulty = DIFFICULTY_EASY;
+            for (int d = DIFFICULTY_MEDIUM; d <= DIFFICULTY_HARD; d++) {
+                if (counts[d] < counts[question.difficulty]) {
+                    question.difficulty = d;
                 }
             }
         }
+        if (question_bank_add(game, &question) < 0) {
+            snprintf(batch->error, sizeof(batch->error), "Could not add question %d", batch->added + 1);
+            batch->failed = true;
+            break;
+        }
+        counts[question.difficulty]++;
+        batch->added++;
+    }
+    free(seen);
+    
+    // One rewrite of the bank and a fresh journal, rather than a journal record per question.
+    // Questions added before a failure are kept.
+    if (batch->added > 0) {
+        save_questions(game);
     }
 }
 
-void edit_question(SDL_Renderer* renderer, TTF_Font* font, GameState* game, int index) {
-    SDL_Color WHITE = {255, 255, 255, 255};
-    SDL_Color BLUE = {0, 0, 128, 255};
-    SDL_Color LIGHT_BLUE = {100, 149, 237, 255};
+void import_done(void* data) {
+    // SDL thread: merge, then report; a batch whose screen has already left is freed here
     SDL_Color GREEN = {0, 255, 0, 255};
+    SDL_Color RED = {255, 0, 0, 255};
     
-    Question* question = &game->questions[index];
+    ImportBatch* batch = data;
+    import_merge(batch);
     
-    // Select what to edit
-    bool done = false;
-    while (!done) {
-        SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
-        SDL_RenderClear(renderer);
-        
-        render_text(renderer, font, "Edit Question", SCREEN_WIDTH/2 - 100, 50, WHITE);
-        
-        render_button(renderer, font, "Edit Question Text", SCREEN_WIDTH/2 - 150, 150, 300, 50, LIGHT_BLUE, WHITE);
+    char summary[IMPORT_PATH_LENGTH];
+    import_summary(batch, summary, sizeof(summary));
+    show_toast(summary, batch->failed ? RED : GREEN, 3000);
+    if (batch->abandoned) {
+        import_batch_free(batch);
+        return;
+    }
+    batch->finished = true;
+}
+
+void import_summary(const ImportBatch* batch, char* text, size_t size) {
+    if (batch->failed) {
+        snprintf(text, size, "Import failed: %s", batch->error);
+        return;
+    }
+    snprintf(text, size, "Imported %d questions, %d duplicates, %d rejected", batch->added, batch->duplicates, batch->rejected);
+}
+
+int run_import(const char* path, bool map_bank) {
+    // Headless import from the command line: parse and merge on this thread, then report
+    GameState game = {0};
+    load_question_bank(&game, map_bank);
+    io_start();
+    
+    int status = 1;
+    ImportBatch* batch = import_batch_new(&game, path);
+    if (batch) {
+        import_run(batch);
+        import_merge(batch);
         
-        for (int i = 0; i < MAX_OPTIONS; i++) {
-            char button_text[50];
-            sprintf(button_text, "Edit Option %d", i + 1);
-            render_button(renderer, font, button_text, SCREEN_WIDTH/2 - 150, 220 + i * 70, 300, 50, LIGHT_BLUE, WHITE);
+        char summary[IMPORT_PATH_LENGTH];
+        import_summary(batch, summary, sizeof(summary));
+        printf("%s\n", summary);
+        if (batch->rejected > 0 && !batch->failed) {
+            printf("First problem: %s\n", batch->error);
         }
+        status = batch->failed ? 1 : 0;
+        import_batch_free(batch);
+    }
+    
+    journal_close(&game);
+    question_bank_free(&game);
+    io_shutdown();
+    return status;
+}
+
+#ifdef __linux__
+int run_server(const char* socket_path, int port, bool map_bank) {
+    // Protocol, one line per message:
+    //   client: START <easy|medium|hard> <name>   begin a quiz
+    //           ANSWER <1-4>                      answer the current question
+    //           QUIT                              close the connection
+    //   server: QUESTION <number> <count> <seconds>, then the question and options, tab separated
+    //           RESULT <CORRECT|WRONG|TIMEOUT> <correct option>
+    //           FINISHED <score> <rank> <players ranked>
+    //           ERROR <reason>
+    GameState game = {0};
+    load_question_bank(&game, map_bank);
+    load_player_history(&game);
+    io_start();
+    
+    QuizServer server = {0};
+    server.game = &game;
+    timer_wheel_init(&server.timers, server_now_ms());
+    server.listen_fd = server_listen(socket_path, port);
+    server.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    
+    int status = 0;
+    struct epoll_event listen_event = {0};
+    listen_event.events = EPOLLIN;
+    listen_event.data.fd = server.listen_fd;
+    if (server.listen_fd < 0 || server.epoll_fd < 0 ||
+        epoll_ctl(server.epoll_fd, EPOLL_CTL_ADD, server.listen_fd, &listen_event) < 0) {
+        status = 1;
+        server_stopping = 1;
+    }
+    
+    // Ctrl+C or a kill stops the loop, a client hanging up must not kill the server
+    struct sigaction stop = {0};
+    stop.sa_handler = server_stop;
+    sigaction(SIGINT, &stop, NULL);
+    sigaction(SIGTERM, &stop, NULL);
+    signal(SIGPIPE, SIG_IGN);
+    if (!server_stopping) {
+        if (socket_path) {
+            printf("Serving quizzes on %s\n", socket_path);
+        } else {
+            printf("Serving quizzes on 127.0.0.1:%d\n", port);
+        }
+    }
+    
+    struct epoll_event events[SERVER_MAX_EVENTS];
+    while (!server_stopping) {
+        Uint64 now = server_now_ms();
+        server_expire_timers(&server, now);
         
-        render_button(renderer, font, "Change Correct Answer", SCREEN_WIDTH/2 - 150, 500, 300, 50, LIGHT_BLUE, WHITE);
-        
-        render_button(renderer, font, "Done", SCREEN_WIDTH/2 - 150, 580, 300, 50, GREEN, WHITE);
-        
-        SDL_RenderPresent(renderer);
+        // Sleep until a socket is ready or the wheel has a deadline to fire
+        int ready = epoll_wait(server.epoll_fd, events, SERVER_MAX_EVENTS, timer_wheel_timeout(&server.timers, now));
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            printf("epoll_wait failed: %s\n", strerror(errno));
+            status = 1;
+            break;
+        }
         
-        SDL_Event event;
-        while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_QUIT) {
-                done = true;
-                break;
+        now = server_now_ms();
+        for (int i = 0; i < ready; i++) {
+            int fd = events[i].data.fd;
+            if (fd == server.listen_fd) {
+                server_accept(&server, now);
+                continue;
             }
             
-            if (event.type == SDL_MOUSEBUTTONDOWN) {
-                int mouse_x, mouse_y;
-                SDL_GetMouseState(&mouse_x, &mouse_y);
-                
-                // Edit Question Text
-                if (is_button_clicked(mouse_x, mouse_y, SCREEN_WIDTH/2 - 150, 150, 300, 50)) {
-                    char new_question[MAX_QUESTION_LENGTH];
-                    get_text_input(renderer, font, new_question, MAX_QUESTION_LENGTH, "Enter new question text:");
-                    strcpy(question->question, new_question);
-                }
-                
-                // Edit Options
-                for (int i = 0; i < MAX_OPTIONS; i++) {
-                    if (is_button_clicked(mouse_x, mouse_y, SCREEN_WIDTH/2 - 150, 220 + i * 70, 300, 50)) {
-                        char new_option[MAX_OPTION_LENGTH];
-                        get_text_input(renderer, font, new_option, MAX_OPTION_LENGTH, "Enter new option text:");
-                        strcpy(question->options[i], new_option);
-                    }
-                }
-                
-                // Change Correct Answer
-                if (is_button_clicked(mouse_x, mouse_y, SCREEN_WIDTH/2 - 150, 500, 300, 50)) {
-                    bool correct_selected = false;
-                    while (!correct_selected) {
-                        SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
-                        SDL_RenderClear(renderer);
-                        
-                        render_text(renderer, font, "Select Correct Option", SCREEN_WIDTH/2 - 100, 100, WHITE);
-                        
-                        for (int i = 0; i < MAX_OPTIONS; i++) {
-                            char button_text[MAX_OPTION_LENGTH + 10];
-                            sprintf(button_text, "%d. %s", i + 1, question->options[i]);
-                            render_button(renderer, font, button_text, SCREEN_WIDTH/2 - 100, 200 + i * 80, 200, 50, LIGHT_BLUE, WHITE);
-                        }
-                        
-                        SDL_RenderPresent(renderer);
-                        
-                        SDL_Event event;
-                        while (SDL_PollEvent(&event)) {
-                            if (event.type == SDL_QUIT) {
-                                correct_selected = true;
-                                break;
-                            }
-                            
-                            if (event.type == SDL_MOUSEBUTTONDOWN) {
-                                int mouse_x, mouse_y;
-                                SDL_GetMouseState(&mouse_x, &mouse_y);
-                                
-                                for (int i = 0; i < MAX_OPTIONS; i++) {
-                                    if (is_button_clicked(mouse_x, mouse_y, SCREEN_WIDTH/2 - 100, 200 + i * 80, 200, 50)) {
-                                        question->correct_option = i;
-                                        correct_selected = true;
-                                        break;
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-                
-                // Done button
-                if (is_button_clicked(mouse_x, mouse_y, SCREEN_WIDTH/2 - 150, 580, 300, 50)) {
-                    done = true;
-                }
+            // A client closed earlier in this batch has no slot any more
+            ServerClient* client = &server.clients[fd];
+            if (client->fd < 0) {
+                continue;
+            }
+            if (events[i].events & EPOLLOUT) {
+                server_flush(&server, client);
+            }
+            if (client->fd >= 0 && (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))) {
+                server_read(&server, client, now);
             }
         }
     }
     
-    // Save changes
-    save_questions(game);
+    // Drop every client, then save the way the windowed game does on exit
+    for (int fd = 0; fd < server.client_capacity; fd++) {
+        if (server.clients[fd].fd >= 0) {
+            server_close_client(&server, &server.clients[fd]);
+        }
+    }
+    free(server.clients);
+    timer_wheel_free(&server.timers);
+    if (server.epoll_fd >= 0) {
+        close(server.epoll_fd);
+    }
+    if (server.listen_fd >= 0) {
+        close(server.listen_fd);
+        if (socket_path) {
+            unlink(socket_path);
+        }
+    }
     
-    // Confirmation
-    SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
-    SDL_RenderClear(renderer);
-    render_text(renderer, font, "Question Updated Successfully!", SCREEN_WIDTH/2 - 150, 250, GREEN);
-    SDL_RenderPresent(renderer);
-    SDL_Delay(1500);
+    leaderboard_free(&game);
+    attempt_history_close(&game);
+    score_log_close(&game);
+    journal_close(&game);
+    question_bank_free(&game);
+    player_registry_free(&game);
+    io_shutdown();
+    return status;
 }
 
-void delete_question(SDL_Renderer* renderer, TTF_Font* font, GameState* game, int index) {
-    SDL_Color WHITE = {255, 255, 255, 255};
-    SDL_Color BLUE = {0, 0, 128, 255};
-    SDL_Color RED = {255, 0, 0, 255};
-    SDL_Color GREEN = {0, 255, 0, 255};
+int server_listen(const char* socket_path, int port) {
+    // A Unix socket at socket_path, or TCP on localhost only
+    int fd = -1;
+    bool listening = false;
+    if (socket_path) {
+        struct sockaddr_un address = {0};
+        address.sun_family = AF_UNIX;
+        if (strlen(socket_path) >= sizeof(address.sun_path)) {
+            printf("Socket path too long: %s\n", socket_path);
+            return -1;
+        }
+        strcpy(address.sun_path, socket_path);
+        
+        // Replace a socket left behind by a server that did not shut down cleanly
+        unlink(socket_path);
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        listening = fd >= 0 && bind(fd, (struct sockaddr*)&address, sizeof(address)) == 0 &&
+                    listen(fd, SOMAXCONN) == 0;
+    } else {
+        struct sockaddr_in address = {0};
+        address.sin_family = AF_INET;
+        address.sin_port = htons((Uint16)port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        
+        int reuse = 1;
+        fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        listening = fd >= 0 && setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) == 0 &&
+                    bind(fd, (struct sockaddr*)&address, sizeof(address)) == 0 && listen(fd, SOMAXCONN) == 0;
+    }
     
-    // Confirm deletion
-    bool confirmed = false;
-    bool quit = false;
+    if (!listening) {
+        printf("Failed to listen for quiz clients: %s\n", strerror(errno));
+        if (fd >= 0) {
+            close(fd);
+        }
+        return -1;
+    }
+    return fd;
+}
+
+Uint64 server_now_ms(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (Uint64)now.tv_sec * 1000 + (Uint64)now.tv_nsec / 1000000;
+}
+
+void server_stop(int signal_number) {
+    (void)signal_number;
+    server_stopping = 1;
+}
+
+bool server_reserve_clients(QuizServer* server, int fd) {
+    // Clients are stored by socket, so the table covers every fd up to the highest open one
+    if (fd < server->client_capacity) {
+        return true;
+    }
     
-    while (!quit) {
-        SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
-        SDL_RenderClear(renderer);
+    int new_capacity = server->client_capacity ? server->client_capacity : 64;
+    while (new_capacity <= fd) {
+        new_capacity *= 2;
+    }
+    if (!timer_wheel_reserve(&server->timers, new_capacity - 1)) {
+        return false;
+    }
+    ServerClient* clients = realloc(server->clients, new_capacity * sizeof(ServerClient));
+    if (!clients) {
+        printf("Failed to grow client table to %d clients!\n", new_capacity);
+        return false;
+    }
+    for (int i = server->client_capacity; i < new_capacity; i++) {
+        memset(&clients[i], 0, sizeof(ServerClient));
+        clients[i].fd = -1;
+    }
+    server->clients = clients;
+    server->client_capacity = new_capacity;
+    return true;
+}
+
+void server_accept(QuizServer* server, Uint64 now) {
+    // Take every pending connection
+    (void)now;
+    for (;;) {
+        int fd = accept4(server->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                printf("accept failed: %s\n", strerror(errno));
+            }
+            return;
+        }
         
-        render_text(renderer, font, "Are you sure you want to delete this question?", SCREEN_WIDTH/2 - 250, 200, WHITE);
+        struct epoll_event event = {0};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (!server_reserve_clients(server, fd) || epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            close(fd);
+            continue;
+        }
         
-        render_button(renderer, font, "Yes", SCREEN_WIDTH/2 - 150, 300, 100, 50, RED, WHITE);
-        render_button(renderer, font, "No", SCREEN_WIDTH/2 + 50, 300, 100, 50, WHITE, BLUE);
+        // Replies are single short lines, send them without waiting to batch (fails harmlessly on Unix sockets)
+        int no_delay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
         
-        SDL_RenderPresent(renderer);
+        ServerClient* client = &server->clients[fd];
+        memset(client, 0, sizeof(ServerClient));
+        client->fd = fd;
+        server->client_count++;
+    }
+}
+
+void server_read(QuizServer* server, ServerClient* client, Uint64 now) {
+    // Read whatever has arrived and handle each complete line, then send the replies
+    char buffer[4096];
+    for (;;) {
+        ssize_t got = recv(client->fd, buffer, sizeof(buffer), 0);
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        if (got <= 0) {
+            server_close_client(server, client);
+            return;
+        }
         
-        SDL_Event event;
-        while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_QUIT) {
-                quit = true;
-                break;
-            }
-            
-            if (event.type == SDL_MOUSEBUTTONDOWN) {
-                int mouse_x, mouse_y;
-                SDL_GetMouseState(&mouse_x, &mouse_y);
-                
-                // Yes button
-                if (is_button_clicked(mouse_x, mouse_y, SCREEN_WIDTH/2 - 150, 300, 100, 50)) {
-                    confirmed = true;
-                    quit = true;
-                }
-                
-                // No button
-                if (is_button_clicked(mouse_x, mouse_y, SCREEN_WIDTH/2 + 50, 300, 100, 50)) {
-                    quit = true;
+        for (ssize_t i = 0; i < got; i++) {
+            if (buffer[i] == '\n') {
+                client->input[client->input_used] = '\0';
+                client->input_used = 0;
+                server_handle_line(server, client, client->input, now);
+                if (client->fd < 0) {
+                    return;
                 }
+            } else if (client->input_used < SERVER_LINE_LENGTH - 1) {
+                client->input[client->input_used++] = buffer[i];
+            } else {
+                server_close_client(server, client);
+                return;
             }
         }
     }
+    server_flush(server, client);
+}
+
+void server_handle_line(QuizServer* server, ServerClient* client, char* line, Uint64 now) {
+    // Accept CRLF line endings too
+    size_t length = strlen(line);
+    if (length > 0 && line[length - 1] == '\r') {
+        line[--length] = '\0';
+    }
     
-    if (confirmed) {
-        // Shift all questions after the deleted one
-        for (int i = index; i < game->total_questions - 1; i++) {
-            game->questions[i] = game->questions[i + 1];
+    if (strncmp(line, "START ", 6) == 0) {
+        if (client->in_quiz) {
+            server_send(server, client, "ERROR quiz already in progress\n");
+            return;
+        }
+        char* difficulty_name = line + 6;
+        char* name = strchr(difficulty_name, ' ');
+        if (!name || name[1] == '\0') {
+            server_send(server, client, "ERROR usage: START <easy|medium|hard> <name>\n");
+            return;
         }
-        game->total_questions--;
+        *name++ = '\0';
         
-        // Save changes
-        save_questions(game);
+        int difficulty = -1;
+        if (strcmp(difficulty_name, "easy") == 0) difficulty = DIFFICULTY_EASY;
+        if (strcmp(difficulty_name, "medium") == 0) difficulty = DIFFICULTY_MEDIUM;
+        if (strcmp(difficulty_name, "hard") == 0) difficulty = DIFFICULTY_HARD;
+        if (difficulty < 0) {
+            server_send(server, client, "ERROR unknown difficulty\n");
+            return;
+        }
         
-        // Confirmation
-        SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
-        SDL_RenderClear(renderer);
-        render_text(renderer, font, "Question Deleted Successfully!", SCREEN_WIDTH/2 - 150, 250, GREEN);
-        SDL_RenderPresent(renderer);
-        SDL_Delay(1500);
+        // Like the menus, refuse a difficulty with nothing to ask rather than record an empty quiz
+        quiz_engine_start(&client->session, server->game, difficulty);
+        if (client->session.question_count == 0) {
+            server_send(server, client, "ERROR no questions for that difficulty\n");
+            return;
+        }
+        snprintf(client->name, MAX_NAME_LENGTH, "%s", name);
+        client->in_quiz = true;
+        server_send_question(server, client, now);
+    } else if (strncmp(line, "ANSWER ", 7) == 0) {
+        if (!client->in_quiz) {
+            server_send(server, client, "ERROR no quiz in progress\n");
+            return;
+        }
+        int option = atoi(line + 7) - 1;
+        if (option < 0 || option >= MAX_OPTIONS) {
+            server_send(server, client, "ERROR answer with 1 to %d\n", MAX_OPTIONS);
+            return;
+        }
+        
+        // The engine treats an answer that came too late as a timeout
+        int correct_option = quiz_engine_question(&client->session, server->game)->correct_option;
+        int result = quiz_engine_submit(&client->session, server->game, option, (Uint32)(now - client->last_tick_ms));
+        client->last_tick_ms = now;
+        server_question_done(server, client, result, correct_option, now);
+    } else if (strcmp(line, "QUIT") == 0) {
+        server_close_client(server, client);
+    } else if (length > 0) {
+        server_send(server, client, "ERROR unknown command\n");
     }
 }
 
-void save_questions(GameState* game) {
-    FILE* file = fopen("quiz_questions.dat", "wb");
-    if (file) {
-        fwrite(&game->total_questions, sizeof(int), 1, file);
-        fwrite(game->questions, sizeof(Question), game->total_questions, file);
-        fclose(file);
+void server_send_question(QuizServer* server, ServerClient* client, Uint64 now) {
+    if (client->fd < 0) {
+        return;
+    }
+    const Question* question = quiz_engine_question(&client->session, server->game);
+    if (!question) {
+        // Out of questions: record the quiz and report where the player now ranks
+        timer_wheel_disarm(&server->timers, client->fd);
+        int id = quiz_engine_finish(&client->session, server->game, client->name, time(NULL));
+        const Leaderboard* ranking = &server->game->leaderboards[client->session.difficulty];
+        server_send(server, client, "FINISHED %d %d %d\n", client->session.score,
+                    id >= 0 ? leaderboard_rank(ranking, id) : 0, ranking->total);
+        client->in_quiz = false;
+        return;
     }
+    
+    client->last_tick_ms = now;
+    timer_wheel_arm(&server->timers, client->fd, now + client->session.time_limit_ms);
+    server_send(server, client, "QUESTION %d %d %d", client->session.current + 1, client->session.question_count,
+                (int)(client->session.time_limit_ms / 1000));
+    server_send_field(server, client, question_text(server->game, question));
+    for (int i = 0; i < MAX_OPTIONS; i++) {
+        server_send_field(server, client, option_text(server->game, question, i));
+    }
+    server_send(server, client, "\n");
 }
 
-void load_questions(GameState* game) {
-    FILE* file = fopen("quiz_questions.dat", "rb");
-    if (file) {
-        fread(&game->total_questions, sizeof(int), 1, file);
-        fread(game->questions, sizeof(Question), game->total_questions, file);
-        fclose(file);
+void server_question_done(QuizServer* server, ServerClient* client, int result, int correct_option, Uint64 now) {
+    static const char* result_names[] = {"NONE", "CORRECT", "WRONG", "TIMEOUT"};
+    server_send(server, client, "RESULT %s %d\n", result_names[result], correct_option + 1);
+    
+    // A client too far behind on reading was dropped by the send, its slot is cleared
+    if (client->fd < 0) {
+        return;
     }
+    server_send_question(server, client, now);
 }
 
-void save_players(GameState* game) {
-    FILE* file = fopen("quiz_players.dat", "wb");
-    if (file) {
-        fwrite(&game->total_players, sizeof(int), 1, file);
-        fwrite(game->players, sizeof(Player), game->total_players, file);
-        fclose(file);
+void server_send(QuizServer* server, ServerClient* client, const char* format, ...) {
+    if (client->fd < 0) {
+        return;
+    }
+    char line[256];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (length < 0) {
+        return;
+    }
+    if ((size_t)length >= sizeof(line)) {
+        length = sizeof(line) - 1;
+    }
+    
+    if (!server_output_reserve(client, length)) {
+        server_close_client(server, client);
+        return;
     }
+    memcpy(client->output + client->output_used, line, length);
+    client->output_used += length;
 }
 
-void load_players(GameState* game) {
-    FILE* file = fopen("quiz_players.dat", "rb");
-    if (file) {
-        fread(&game->total_players, sizeof(int), 1, file);
-        fread(game->players, sizeof(Player), game->total_players, file);
-        fclose(file);
+void server_send_field(QuizServer* server, ServerClient* client, const char* text) {
+    // A tab, then the text with anything that would break the line format blanked out
+    if (client->fd < 0) {
+        return;
+    }
+    size_t length = strlen(text);
+    if (!server_output_reserve(client, length + 1)) {
+        server_close_client(server, client);
+        return;
+    }
+    char* out = client->output + client->output_used;
+    *out++ = '\t';
+    for (size_t i = 0; i < length; i++) {
+        out[i] = (text[i] == '\t' || text[i] == '\n' || text[i] == '\r') ? ' ' : text[i];
     }
+    client->output_used += length + 1;
 }
 
-void add_default_questions(GameState* game) {
-    // Easy Questions (11 total)
-    strcpy(game->questions[game->total_questions].question, "What is 2 + 2?");
-    strcpy(game->questions[game->total_questions].options[0], "3");
-    strcpy(game->questions[game->total_questions].options[1], "4");
-    strcpy(game->questions[game->total_questions].options[2], "5");
-    strcpy(game->questions[game->total_questions].options[3], "6");
-    game->questions[game->total_questions].correct_option = 1;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_EASY;
-    game->total_questions++;
-
-    strcpy(game->questions[game->total_questions].question, "What is the capital of France?");
-    strcpy(game->questions[game->total_questions].options[0], "London");
-    strcpy(game->questions[game->total_questions].options[1], "Berlin");
-    strcpy(game->questions[game->total_questions].options[2], "Paris");
-    strcpy(game->questions[game->total_questions].options[3], "Madrid");
-    game->questions[game->total_questions].correct_option = 2;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_EASY;
-    game->total_questions++;
-
-    strcpy(game->questions[game->total_questions].question, "Which planet is closest to the sun?");
-    strcpy(game->questions[game->total_questions].options[0], "Venus");
-    strcpy(game->questions[game->total_questions].options[1], "Mars");
-    strcpy(game->questions[game->total_questions].options[2], "Mercury");
-    strcpy(game->questions[game->total_questions].options[3], "Earth");
-    game->questions[game->total_questions].correct_option = 2;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_EASY;
-    game->total_questions++;
-
-    strcpy(game->questions[game->total_questions].question, "How many continents are there?");
-    strcpy(game->questions[game->total_questions].options[0], "5");
-    strcpy(game->questions[game->total_questions].options[1], "6");
-    strcpy(game->questions[game->total_questions].options[2], "7");
-    strcpy(game->questions[game->total_questions].options[3], "8");
-    game->questions[game->total_questions].correct_option = 2;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_EASY;
-    game->total_questions++;
-
-    strcpy(game->questions[game->total_questions].question, "What is the largest ocean on Earth?");
-    strcpy(game->questions[game->total_questions].options[0], "Atlantic");
-    strcpy(game->questions[game->total_questions].options[1], "Indian");
-    strcpy(game->questions[game->total_questions].options[2], "Arctic");
-    strcpy(game->questions[game->total_questions].options[3], "Pacific");
-    game->questions[game->total_questions].correct_option = 3;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_EASY;
-    game->total_questions++;
-
-    strcpy(game->questions[game->total_questions].question, "What color is a banana?");
-    strcpy(game->questions[game->total_questions].options[0], "Red");
-    strcpy(game->questions[game->total_questions].options[1], "Green");
-    strcpy(game->questions[game->total_questions].options[2], "Yellow");
-    strcpy(game->questions[game->total_questions].options[3], "Blue");
-    game->questions[game->total_questions].correct_option = 2;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_EASY;
-    game->total_questions++;
-
-    strcpy(game->questions[game->total_questions].question, "How many days are in a week?");
-    strcpy(game->questions[game->total_questions].options[0], "5");
-    strcpy(game->questions[game->total_questions].options[1], "6");
-    strcpy(game->questions[game->total_questions].options[2], "7");
-    strcpy(game->questions[game->total_questions].options[3], "8");
-    game->questions[game->total_questions].correct_option = 2;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_EASY;
-    game->total_questions++;
-
-    strcpy(game->questions[game->total_questions].question, "Which season comes after winter?");
-    strcpy(game->questions[game->total_questions].options[0], "Summer");
-    strcpy(game->questions[game->total_questions].options[1], "Spring");
-    strcpy(game->questions[game->total_questions].options[2], "Fall");
-    strcpy(game->questions[game->total_questions].options[3], "Autumn");
-    game->questions[game->total_questions].correct_option = 1;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_EASY;
-    game->total_questions++;
-
-    strcpy(game->questions[game->total_questions].question, "What animal says 'moo'?");
-    strcpy(game->questions[game->total_questions].options[0], "Sheep");
-    strcpy(game->questions[game->total_questions].options[1], "Cow");
-    strcpy(game->questions[game->total_questions].options[2], "Pig");
-    strcpy(game->questions[game->total_questions].options[3], "Horse");
-    game->questions[game->total_questions].correct_option = 1;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_EASY;
-    game->total_questions++;
-
-    strcpy(game->questions[game->total_questions].question, "What is 10 divided by 2?");
-    strcpy(game->questions[game->total_questions].options[0], "5");
-    strcpy(game->questions[game->total_questions].options[1], "8");
-    strcpy(game->questions[game->total_questions].options[2], "12");
-    strcpy(game->questions[game->total_questions].options[3], "20");
-    game->questions[game->total_questions].correct_option = 0;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_EASY;
-    game->total_questions++;
-
-    strcpy(game->questions[game->total_questions].question, "What do bees make?");
-    strcpy(game->questions[game->total_questions].options[0], "Silk");
-    strcpy(game->questions[game->total_questions].options[1], "Milk");
-    strcpy(game->questions[game->total_questions].options[2], "Honey");
-    strcpy(game->questions[game->total_questions].options[3], "Juice");
-    game->questions[game->total_questions].correct_option = 2;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_EASY;
-    game->total_questions++;
-
-    // Medium Questions (11 total)
-    strcpy(game->questions[game->total_questions].question, "What is the square root of 64?");
-    strcpy(game->questions[game->total_questions].options[0], "4");
-    strcpy(game->questions[game->total_questions].options[1], "6");
-    strcpy(game->questions[game->total_questions].options[2], "8");
-    strcpy(game->questions[game->total_questions].options[3], "10");
-    game->questions[game->total_questions].correct_option = 2;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_MEDIUM;
-    game->total_questions++;
-
-    strcpy(game->questions[game->total_questions].question, "Which planet is known as the Red Planet?");
-    strcpy(game->questions[game->total_questions].options[0], "Venus");
-    strcpy(game->questions[game->total_questions].options[1], "Mars");
-    strcpy(game->questions[game->total_questions].options[2], "Jupiter");
-    strcpy(game->questions[game->total_questions].options[3], "Saturn");
-    game->questions[game->total_questions].correct_option = 1;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_MEDIUM;
-    game->total_questions++;
-
-    strcpy(game->questions[game->total_questions].question, "What is the chemical symbol for water?");
-    strcpy(game->questions[game->total_questions].options[0], "H2O");
-    strcpy(game->questions[game->total_questions].options[1], "CO2");
-    strcpy(game->questions[game->total_questions].options[2], "NaCl");
-    strcpy(game->questions[game->total_questions].options[3], "O2");
-    game->questions[game->total_questions].correct_option = 0;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_MEDIUM;
-    game->total_questions++;
-
-    strcpy(game->questions[game->total_questions].question, "Who wrote 'Romeo and Juliet'?");
-    strcpy(game->questions[game->total_questions].options[0], "Charles Dickens");
-    strcpy(game->questions[game->total_questions].options[1], "William Shakespeare");
-    strcpy(game->questions[game->total_questions].options[2], "Jane Austen");
-    strcpy(game->questions[game->total_questions].options[3], "Mark Twain");
-    game->questions[game->total_questions].correct_option = 1;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_MEDIUM;
-    game->total_questions++;
-
-    strcpy(game->questions[game->total_questions].question, "What is the capital of Japan?");
-    strcpy(game->questions[game->total_questions].options[0], "Beijing");
-    strcpy(game->questions[game->total_questions].options[1], "Seoul");
-    strcpy(game->questions[game->total_questions].options[2], "Tokyo");
-    strcpy(game->questions[game->total_questions].options[3], "Bangkok");
-    game->questions[game->total_questions].correct_option = 2;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_MEDIUM;
-    game->total_questions++;
-
-    strcpy(game->questions[game->total_questions].question, "What is the name of the longest river in Africa?");
-    strcpy(game->questions[game->total_questions].options[0], "Amazon");
-    strcpy(game->questions[game->total_questions].options[1], "Nile");
-    strcpy(game->questions[game->total_questions].options[2], "Mississippi");
-    strcpy(game->questions[game->total_questions].options[3], "Yangtze");
-    game->questions[game->total_questions].correct_option = 1;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_MEDIUM;
-    game->total_questions++;
-
-    strcpy(game->questions[game->total_questions].question, "What is the boiling point of water in Celsius?");
-    strcpy(game->questions[game->total_questions].options[0], "90°C");
-    strcpy(game->questions[game->total_questions].options[1], "100°C");
-    strcpy(game->questions[game->total_questions].options[2], "110°C");
-    strcpy(game->questions[game->total_questions].options[3], "212°C");
-    game->questions[game->total_questions].correct_option = 1;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_MEDIUM;
-    game->total_questions++;
-
-    strcpy(game->questions[game->total_questions].question, "Which musical instrument has 88 keys?");
-    strcpy(game->questions[game->total_questions].options[0], "Guitar");
-    strcpy(game->questions[game->total_questions].options[1], "Violin");
-    strcpy(game->questions[game->total_questions].options[2], "Piano");
-    strcpy(game->questions[game->total_questions].options[3], "Flute");
-    game->questions[game->total_questions].correct_option = 2;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_MEDIUM;
-    game->total_questions++;
-
-    strcpy(game->questions[game->total_questions].question, "Which bone is the longest in the human body?");
-    strcpy(game->questions[game->total_questions].options[0], "Femur");
-    strcpy(game->questions[game->total_questions].options[1], "Spine");
-    strcpy(game->questions[game->total_questions].options[2], "Tibia");
-    strcpy(game->questions[game->total_questions].options[3], "Humerus");
-    game->questions[game->total_questions].correct_option = 0;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_MEDIUM;
-    game->total_questions++;
-
-    strcpy(game->questions[game->total_questions].question, "How many sides does a hexagon have?");
-    strcpy(game->questions[game->total_questions].options[0], "5");
-    strcpy(game->questions[game->total_questions].options[1], "6");
-    strcpy(game->questions[game->total_questions].options[2], "7");
-    strcpy(game->questions[game->total_questions].options[3], "8");
-    game->questions[game->total_questions].correct_option = 1;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_MEDIUM;
-    game->total_questions++;
-
-    strcpy(game->questions[game->total_questions].question, "What gas do plants absorb from the atmosphere?");
-    strcpy(game->questions[game->total_questions].options[0], "Oxygen");
-    strcpy(game->questions[game->total_questions].options[1], "Nitrogen");
-    strcpy(game->questions[game->total_questions].options[2], "Carbon Dioxide");
-    strcpy(game->questions[game->total_questions].options[3], "Hydrogen");
-    game->questions[game->total_questions].correct_option = 2;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_MEDIUM;
-    game->total_questions++;
-
-    // Hard Questions (11 total)
-    strcpy(game->questions[game->total_questions].question, "What is the chemical symbol for Gold?");
-    strcpy(game->questions[game->total_questions].options[0], "Go");
-    strcpy(game->questions[game->total_questions].options[1], "Gd");
-    strcpy(game->questions[game->total_questions].options[2], "Au");
-    strcpy(game->questions[game->total_questions].options[3], "Ag");
-    game->questions[game->total_questions].correct_option = 2;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_HARD;
-    game->total_questions++;
-
-    strcpy(game->questions[game->total_questions].question, "Who painted the Mona Lisa?");
-    strcpy(game->questions[game->total_questions].options[0], "Vincent van Gogh");
-    strcpy(game->questions[game->total_questions].options[1], "Pablo Picasso");
-    strcpy(game->questions[game->total_questions].options[2], "Leonardo da Vinci");
-    strcpy(game->questions[game->total_questions].options[3], "Michelangelo");
-    game->questions[game->total_questions].correct_option = 2;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_HARD;
-    game->total_questions++;
-
-    strcpy(game->questions[game->total_questions].question, "What is the largest planet in our solar system?");
-    strcpy(game->questions[game->total_questions].options[0], "Earth");
-    strcpy(game->questions[game->total_questions].options[1], "Saturn");
-    strcpy(game->questions[game->total_questions].options[2], "Jupiter");
-    strcpy(game->questions[game->total_questions].options[3], "Neptune");
-    game->questions[game->total_questions].correct_option = 2;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_HARD;
-    game->total_questions++;
-
-    strcpy(game->questions[game->total_questions].question, "Which element has the atomic number 1?");
-    strcpy(game->questions[game->total_questions].options[0], "Helium");
-    strcpy(game->questions[game->total_questions].options[1], "Hydrogen");
-    strcpy(game->questions[game->total_questions].options[2], "Oxygen");
-    strcpy(game->questions[game->total_questions].options[3], "Carbon");
-    game->questions[game->total_questions].correct_option = 1;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_HARD;
-    game->total_questions++;
-
-    strcpy(game->questions[game->total_questions].question, "In which year did World War II end?");
-    strcpy(game->questions[game->total_questions].options[0], "1943");
-    strcpy(game->questions[game->total_questions].options[1], "1945");
-    strcpy(game->questions[game->total_questions].options[2], "1947");
-    strcpy(game->questions[game->total_questions].options[3], "1950");
-    game->questions[game->total_questions].correct_option = 1;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_HARD;
-    game->total_questions++;
-
-    strcpy(game->questions[game->total_questions].question, "What is the smallest bone in the human body?");
-    strcpy(game->questions[game->total_questions].options[0], "Stapes");
-    strcpy(game->questions[game->total_questions].options[1], "Femur");
-    strcpy(game->questions[game->total_questions].options[2], "Radius");
-    strcpy(game->questions[game->total_questions].options[3], "Patella");
-    game->questions[game->total_questions].correct_option = 0;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_HARD;
-    game->total_questions++;
-
-    strcpy(game->questions[game->total_questions].question, "Who was the first woman to win a Nobel Prize?");
-    strcpy(game->questions[game->total_questions].options[0], "Marie Curie");
-    strcpy(game->questions[game->total_questions].options[1], "Rosalind Franklin");
-    strcpy(game->questions[game->total_questions].options[2], "Ada Lovelace");
-    strcpy(game->questions[game->total_questions].options[3], "Dorothy Hodgkin");
-    game->questions[game->total_questions].correct_option = 0;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_HARD;
-    game->total_questions++;
-
-    strcpy(game->questions[game->total_questions].question, "What is the capital of Australia?");
-    strcpy(game->questions[game->total_questions].options[0], "Sydney");
-    strcpy(game->questions[game->total_questions].options[1], "Melbourne");
-    strcpy(game->questions[game->total_questions].options[2], "Canberra");
-    strcpy(game->questions[game->total_questions].options[3], "Perth");
-    game->questions[game->total_questions].correct_option = 2;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_HARD;
-    game->total_questions++;
-
-    strcpy(game->questions[game->total_questions].question, "In what year was the first iPhone released?");
-    strcpy(game->questions[game->total_questions].options[0], "2005");
-    strcpy(game->questions[game->total_questions].options[1], "2007");
-    strcpy(game->questions[game->total_questions].options[2], "2009");
-    strcpy(game->questions[game->total_questions].options[3], "2010");
-    game->questions[game->total_questions].correct_option = 1;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_HARD;
-    game->total_questions++;
-
-    strcpy(game->questions[game->total_questions].question, "What is the speed of light in vacuum?");
-    strcpy(game->questions[game->total_questions].options[0], "299,792 km/s");
-    strcpy(game->questions[game->total_questions].options[1], "300,000 km/s");
-    strcpy(game->questions[game->total_questions].options[2], "310,000 km/s");
-    strcpy(game->questions[game->total_questions].options[3], "250,000 km/s");
-    game->questions[game->total_questions].correct_option = 0;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_HARD;
-    game->total_questions++;
-
-    strcpy(game->questions[game->total_questions].question, "What is the chemical formula for sulfuric acid?");
-    strcpy(game->questions[game->total_questions].options[0], "H2SO3");
-    strcpy(game->questions[game->total_questions].options[1], "H2SO4");
-    strcpy(game->questions[game->total_questions].options[2], "HNO3");
-    strcpy(game->questions[game->total_questions].options[3], "HCl");
-    game->questions[game->total_questions].correct_option = 1;
-    game->questions[game->total_questions].difficulty = DIFFICULTY_HARD;
-    game->total_questions++;
-}
-
-void shuffle_questions(Question* questions, int count) {
-    for (int i = count - 1; i > 0; i--) {
-        int j = rand() % (i + 1);
-        Question temp = questions[i];
-        questions[i] = questions[j];
-        questions[j] = temp;
+bool server_output_reserve(ServerClient* client, size_t extra) {
+    // False once a client has stopped reading and its backlog reaches the limit
+    size_t needed = client->output_used + extra;
+    if (needed > SERVER_OUTPUT_LIMIT) {
+        return false;
+    }
+    if (needed <= client->output_capacity) {
+        return true;
+    }
+    
+    size_t new_capacity = client->output_capacity ? client->output_capacity : 1024;
+    while (new_capacity < needed) {
+        new_capacity *= 2;
+    }
+    char* output = realloc(client->output, new_capacity);
+    if (!output) {
+        return false;
+    }
+    client->output = output;
+    client->output_capacity = new_capacity;
+    return true;
+}
+
+void server_flush(QuizServer* server, ServerClient* client) {
+    // Write as much pending output as the socket takes, and wait for EPOLLOUT for the rest
+    size_t sent = 0;
+    while (sent < client->output_used) {
+        ssize_t wrote = send(client->fd, client->output + sent, client->output_used - sent, MSG_NOSIGNAL);
+        if (wrote < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            server_close_client(server, client);
+            return;
+        }
+        sent += (size_t)wrote;
+    }
+    memmove(client->output, client->output + sent, client->output_used - sent);
+    client->output_used -= sent;
+    
+    bool want_write = client->output_used > 0;
+    if (want_write != client->want_write) {
+        struct epoll_event event = {0};
+        event.events = EPOLLIN | (want_write ? EPOLLOUT : 0);
+        event.data.fd = client->fd;
+        epoll_ctl(server->epoll_fd, EPOLL_CTL_MOD, client->fd, &event);
+        client->want_write = want_write;
+    }
+}
+
+void server_close_client(QuizServer* server, ServerClient* client) {
+    // A quiz left unfinished is dropped without a score, as when the window is closed mid-quiz
+    timer_wheel_disarm(&server->timers, client->fd);
+    epoll_ctl(server->epoll_fd, EPOLL_CTL_DEL, client->fd, NULL);
+    close(client->fd);
+    free(client->output);
+    memset(client, 0, sizeof(ServerClient));
+    client->fd = -1;
+    server->client_count--;
+}
+
+void server_expire_timers(QuizServer* server, Uint64 now) {
+    // Each fired timer is a client whose question has run out of time
+    int fd;
+    while ((fd = timer_wheel_expire(&server->timers, now)) >= 0) {
+        ServerClient* client = &server->clients[fd];
+        int correct_option = quiz_engine_question(&client->session, server->game)->correct_option;
+        int result = quiz_engine_tick(&client->session, (Uint32)(now - client->last_tick_ms));
+        client->last_tick_ms = now;
+        server_question_done(server, client, result, correct_option, now);
+        if (client->fd >= 0) {
+            server_flush(server, client);
+        }
     }
 }
+#else
+int run_server(const char* socket_path, int port, bool map_bank) {
+    (void)socket_path;
+    (void)port;
+    (void)map_bank;
+    printf("Server mode needs epoll and is only available on Linux\n");
+    return 1;
+}
+#endif
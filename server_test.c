@@ -0,0 +1,369 @@
+// Stand-in clients for quiz server mode. Starts "quiz --server" in a scratch directory
+// with a small question bank, runs scripted sessions against it and checks the replies.
+//
+//   cc -o server_test server_test.c
+//   ./server_test ./quiz
+//
+// Exits 0 when every check passes. The timeout check waits out one full question,
+// so a run takes a little over QUESTION_TIME seconds.
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+// Must match quiz.c
+#define MAX_QUESTION_LENGTH 256
+#define MAX_OPTIONS 4
+#define MAX_OPTION_LENGTH 128
+#define QUESTION_TIME 30
+#define SERVER_OUTPUT_LIMIT (64 * 1024)
+
+#define LINE_LENGTH 1024
+#define REPLY_WAIT_MS 5000 // Longest wait for a reply that should come at once
+#define EASY_QUESTIONS 2
+#define SLOW_READERS 32 // Where each one's backlog crosses the limit varies, so try many
+
+// Bank record of the format quiz.c loads from quiz_questions.dat before its versioned one:
+// a native int count followed by these structs. Only easy questions are written, so medium
+// and hard are empty.
+typedef struct {
+    char question[MAX_QUESTION_LENGTH];
+    char options[MAX_OPTIONS][MAX_OPTION_LENGTH];
+    int correct_option;
+    int difficulty;
+} QuestionRecord;
+
+// One connection and the replies read from it but not yet consumed
+typedef struct {
+    int fd;
+    char buffer[8192];
+    size_t used;
+} Client;
+
+static const char* bank_questions[EASY_QUESTIONS] = {"First test question?", "Second test question?"};
+static const int bank_answers[EASY_QUESTIONS] = {2, 4}; // 1-based, as the protocol counts
+static char socket_path[108]; // Size of sockaddr_un.sun_path
+static pid_t server_pid = -1;
+static int failures = 0;
+
+void check(bool ok, const char* what, const char* detail) {
+    if (!ok) {
+        printf("FAIL %s%s%s\n", what, detail ? ": " : "", detail ? detail : "");
+        failures++;
+    }
+}
+
+bool write_bank(void) {
+    QuestionRecord records[EASY_QUESTIONS];
+    memset(records, 0, sizeof(records));
+    for (int i = 0; i < EASY_QUESTIONS; i++) {
+        snprintf(records[i].question, MAX_QUESTION_LENGTH, "%s", bank_questions[i]);
+        for (int j = 0; j < MAX_OPTIONS; j++) {
+            snprintf(records[i].options[j], MAX_OPTION_LENGTH, "Option %d", j + 1);
+        }
+        records[i].correct_option = bank_answers[i] - 1;
+        records[i].difficulty = 0;
+    }
+    
+    FILE* file = fopen("quiz_questions.dat", "wb");
+    if (!file) {
+        return false;
+    }
+    int count = EASY_QUESTIONS;
+    bool written = fwrite(&count, sizeof(int), 1, file) == 1 &&
+                   fwrite(records, sizeof(QuestionRecord), EASY_QUESTIONS, file) == EASY_QUESTIONS;
+    return fclose(file) == 0 && written;
+}
+
+bool client_connect(Client* client) {
+    memset(client, 0, sizeof(Client));
+    client->fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (client->fd < 0) {
+        return false;
+    }
+    struct sockaddr_un address = {0};
+    address.sun_family = AF_UNIX;
+    snprintf(address.sun_path, sizeof(address.sun_path), "%s", socket_path);
+    if (connect(client->fd, (struct sockaddr*)&address, sizeof(address)) < 0) {
+        close(client->fd);
+        client->fd = -1;
+        return false;
+    }
+    return true;
+}
+
+void client_close(Client* client) {
+    if (client->fd >= 0) {
+        close(client->fd);
+        client->fd = -1;
+    }
+}
+
+void client_send(Client* client, const char* format, ...) {
+    char line[LINE_LENGTH];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (write(client->fd, line, length) != length) {
+        check(false, "send", strerror(errno));
+    }
+}
+
+int client_read_line(Client* client, char* line, int timeout_ms) {
+    // 1 with a line (newline stripped), 0 when the server closed the connection, -1 on timeout
+    while (true) {
+        char* newline = memchr(client->buffer, '\n', client->used);
+        if (newline) {
+            size_t length = newline - client->buffer;
+            if (length >= LINE_LENGTH) {
+                length = LINE_LENGTH - 1;
+            }
+            memcpy(line, client->buffer, length);
+            line[length] = '\0';
+            client->used -= newline + 1 - client->buffer;
+            memmove(client->buffer, newline + 1, client->used);
+            return 1;
+        }
+        
+        struct pollfd ready = {client->fd, POLLIN, 0};
+        if (poll(&ready, 1, timeout_ms) <= 0) {
+            return -1;
+        }
+        ssize_t got = read(client->fd, client->buffer + client->used, sizeof(client->buffer) - client->used);
+        if (got <= 0) {
+            return 0;
+        }
+        client->used += got;
+    }
+}
+
+bool expect(Client* client, const char* prefix, char* line, int timeout_ms) {
+    // Read the next reply and check how it starts; line keeps it for further checks
+    int result = client_read_line(client, line, timeout_ms);
+    if (result <= 0) {
+        check(false, prefix, result == 0 ? "connection closed" : "no reply");
+        line[0] = '\0';
+        return false;
+    }
+    if (strncmp(line, prefix, strlen(prefix)) != 0) {
+        check(false, prefix, line);
+        return false;
+    }
+    return true;
+}
+
+int question_answer(const char* line) {
+    // The correct option for a QUESTION line, from the question text after the first tab
+    const char* text = strchr(line, '\t');
+    for (int i = 0; text && i < EASY_QUESTIONS; i++) {
+        if (strncmp(text + 1, bank_questions[i], strlen(bank_questions[i])) == 0) {
+            return bank_answers[i];
+        }
+    }
+    return -1;
+}
+
+bool server_alive(void) {
+    return waitpid(server_pid, NULL, WNOHANG) == 0;
+}
+
+void test_session(void) {
+    // A whole quiz: one right answer, one wrong, then the final score and rank
+    Client client;
+    char line[LINE_LENGTH];
+    if (!client_connect(&client)) {
+        check(false, "session connect", strerror(errno));
+        return;
+    }
+    
+    client_send(&client, "ANSWER 1\n");
+    expect(&client, "ERROR no quiz in progress", line, REPLY_WAIT_MS);
+    client_send(&client, "START easy alice\n");
+    if (expect(&client, "QUESTION 1 2 ", line, REPLY_WAIT_MS)) {
+        int tabs = 0;
+        for (char* c = line; *c; c++) {
+            tabs += *c == '\t';
+        }
+        check(tabs == 1 + MAX_OPTIONS, "question fields", line);
+    }
+    int answer = question_answer(line);
+    check(answer > 0, "question text", line);
+    
+    client_send(&client, "ANSWER 9\n");
+    expect(&client, "ERROR answer with 1 to 4", line, REPLY_WAIT_MS);
+    client_send(&client, "ANSWER %d\n", answer);
+    char wanted[64];
+    snprintf(wanted, sizeof(wanted), "RESULT CORRECT %d", answer);
+    expect(&client, wanted, line, REPLY_WAIT_MS);
+    
+    expect(&client, "QUESTION 2 2 ", line, REPLY_WAIT_MS);
+    answer = question_answer(line);
+    client_send(&client, "ANSWER %d\n", answer % MAX_OPTIONS + 1);
+    snprintf(wanted, sizeof(wanted), "RESULT WRONG %d", answer);
+    expect(&client, wanted, line, REPLY_WAIT_MS);
+    expect(&client, "FINISHED 4 1 1", line, REPLY_WAIT_MS);
+    
+    client_send(&client, "QUIT\n");
+    check(client_read_line(&client, line, REPLY_WAIT_MS) == 0, "quit closes the connection", NULL);
+    client_close(&client);
+}
+
+void test_empty_difficulty(void) {
+    // Nothing to ask: refused and not recorded, so the player can still start a real quiz
+    Client client;
+    char line[LINE_LENGTH];
+    if (!client_connect(&client)) {
+        check(false, "empty difficulty connect", strerror(errno));
+        return;
+    }
+    client_send(&client, "START hard bob\n");
+    expect(&client, "ERROR no questions for that difficulty", line, REPLY_WAIT_MS);
+    client_send(&client, "START medium bob\n");
+    expect(&client, "ERROR no questions for that difficulty", line, REPLY_WAIT_MS);
+    client_send(&client, "START easy bob\n");
+    expect(&client, "QUESTION 1 2 ", line, REPLY_WAIT_MS);
+    client_close(&client);
+}
+
+void test_slow_reader(void) {
+    // A client that keeps sending but never reads is dropped once its replies back up
+    // past SERVER_OUTPUT_LIMIT. The limit may be crossed by any reply, a RESULT, a
+    // QUESTION or a FINISHED line, and each must leave the server serving everyone else.
+    Client client;
+    if (!client_connect(&client)) {
+        check(false, "slow reader connect", strerror(errno));
+        return;
+    }
+    
+    char burst[LINE_LENGTH];
+    int length = snprintf(burst, sizeof(burst), "START easy slow\nANSWER 1\nANSWER 1\n");
+    size_t sent = 0;
+    bool dropped = false;
+    struct pollfd ready = {client.fd, POLLOUT, 0};
+    while (sent < 64 * 1024 * 1024) {
+        if (poll(&ready, 1, REPLY_WAIT_MS) <= 0) {
+            break;
+        }
+        ssize_t wrote = send(client.fd, burst, length, MSG_NOSIGNAL);
+        if (wrote < 0) {
+            dropped = errno == EPIPE || errno == ECONNRESET;
+            break;
+        }
+        sent += wrote;
+    }
+    char detail[64];
+    snprintf(detail, sizeof(detail), "%zu bytes sent", sent);
+    check(dropped, "slow reader dropped", detail);
+    client_close(&client);
+    
+    check(server_alive(), "server survives a slow reader", NULL);
+    Client next;
+    char line[LINE_LENGTH];
+    if (client_connect(&next)) {
+        client_send(&next, "START easy after\n");
+        expect(&next, "QUESTION 1 2 ", line, REPLY_WAIT_MS);
+        client_close(&next);
+    } else {
+        check(false, "connect after a slow reader", strerror(errno));
+    }
+}
+
+void test_timeout(void) {
+    // An unanswered question times out on the server's clock and the quiz moves on
+    Client client;
+    char line[LINE_LENGTH];
+    if (!client_connect(&client)) {
+        check(false, "timeout connect", strerror(errno));
+        return;
+    }
+    client_send(&client, "START easy carol\n");
+    expect(&client, "QUESTION 1 2 30", line, REPLY_WAIT_MS);
+    int answer = question_answer(line);
+    
+    time_t started = time(NULL);
+    char wanted[64];
+    snprintf(wanted, sizeof(wanted), "RESULT TIMEOUT %d", answer);
+    expect(&client, wanted, line, (QUESTION_TIME + 5) * 1000);
+    check(time(NULL) - started >= QUESTION_TIME - 1, "timeout not early", NULL);
+    expect(&client, "QUESTION 2 2 ", line, REPLY_WAIT_MS);
+    client_close(&client);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        printf("usage: %s QUIZ_BINARY\n", argv[0]);
+        return 2;
+    }
+    char quiz[PATH_MAX];
+    if (!realpath(argv[1], quiz)) {
+        printf("Cannot find %s\n", argv[1]);
+        return 2;
+    }
+
+    // The server reads and writes its data files in the working directory, so give it a fresh one
+    char directory[] = "/tmp/quiz_server_test.XXXXXX";
+    if (!mkdtemp(directory) || chdir(directory) != 0 || !write_bank()) {
+        printf("Cannot set up %s\n", directory);
+        return 2;
+    }
+    snprintf(socket_path, sizeof(socket_path), "%s/quiz.sock", directory);
+    signal(SIGPIPE, SIG_IGN);
+
+    server_pid = fork();
+    if (server_pid == 0) {
+        int null_fd = open("/dev/null", O_WRONLY);
+        dup2(null_fd, STDOUT_FILENO);
+        execl(quiz, quiz, "--server", socket_path, (char*)NULL);
+        _exit(127);
+    }
+
+    // Wait for the socket to accept connections
+    Client probe;
+    bool up = false;
+    for (int i = 0; i < 100 && !up && server_alive(); i++) {
+        up = client_connect(&probe);
+        if (!up) {
+            usleep(100 * 1000);
+        }
+    }
+    if (!up) {
+        printf("Server did not start\n");
+        return 2;
+    }
+    client_close(&probe);
+
+    test_session();
+    test_empty_difficulty();
+    for (int i = 0; i < SLOW_READERS && server_alive(); i++) {
+        test_slow_reader();
+    }
+    test_timeout();
+
+    // The server saves and exits cleanly on SIGTERM
+    int status = 0;
+    kill(server_pid, SIGTERM);
+    waitpid(server_pid, &status, 0);
+    check(WIFEXITED(status) && WEXITSTATUS(status) == 0, "server exit status", NULL);
+
+    char command[PATH_MAX + 16];
+    snprintf(command, sizeof(command), "rm -rf %s", directory);
+    if (system(command) != 0) {
+        printf("Could not remove %s\n", directory);
+    }
+
+    printf("%s: %d failed\n", failures ? "FAIL" : "OK", failures);
+    return failures ? 1 : 0;
+}